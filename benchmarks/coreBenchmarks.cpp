@@ -0,0 +1,344 @@
+// Microbenchmarks for the gameplay hot paths in core/game.cpp
+// Run with --benchmark_out=<file> --benchmark_out_format=json (or build the core_benchmarks_json target)
+// and diff the results between commits with benchmark's tools/compare.py
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "autopilot.h"
+#include "breakoutEnv.h"
+#include "compactGame.h"
+#include "game.h"
+#include "observationRenderer.h"
+
+// ball in the middle of the screen, below every brick, so a collision check has to visit the whole board
+static const SDL_Rect MISSING_BALL { (GAME_WIDTH - BALL_WIDTH) / 2, (GAME_HEIGHT - BALL_HEIGHT) / 2, BALL_WIDTH, BALL_HEIGHT };
+
+static void BM_CanRectanglesOverlap(benchmark::State& state) {
+	const int count = 1024;
+	SDL_Rect rects[count];
+	srand(1);
+	for (int i = 0; i < count; ++i) {
+		rects[i] = { rand() % GAME_WIDTH, rand() % GAME_HEIGHT, BRICK_WIDTH, BRICK_HEIGHT };
+	}
+
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(canRectanglesOverlap(MISSING_BALL, rects[i]));
+		i = (i + 1) & (count - 1);
+	}
+}
+BENCHMARK(BM_CanRectanglesOverlap);
+
+// range(0) is the percentage of bricks still standing
+static void BM_CheckBrickCollision(benchmark::State& state) {
+	SDL_Rect bricks[BRICKS_COUNT];
+	BrickState brickStates[BRICKS_COUNT];
+	initBrickPositions(bricks, LAYERS, BRICKS_PER_LAYER, BRICK_WIDTH, BRICK_HEIGHT, BRICK_HORIZ_PADDING, BRICK_VERT_PADDING);
+	ResetBrickMap(brickStates);
+
+	// knock out every other brick until the requested percentage is left standing
+	int destroyed = BRICKS_COUNT - (BRICKS_COUNT * state.range(0)) / 100;
+	for (int i = 0; i < BRICKS_COUNT && destroyed > 0; i += 2, --destroyed) {
+		brickStates[i] = DamageBrick(brickStates[i]);
+	}
+	for (int i = 1; i < BRICKS_COUNT && destroyed > 0; i += 2, --destroyed) {
+		brickStates[i] = DamageBrick(brickStates[i]);
+	}
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(checkBrickCollision(bricks, brickStates, BRICKS_COUNT, MISSING_BALL, 0.0f, 0.0f));
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_CheckBrickCollision)->Arg(100)->Arg(50)->Arg(0);
+
+static void BM_InitBrickPositions(benchmark::State& state) {
+	SDL_Rect bricks[BRICKS_COUNT];
+	for (auto _ : state) {
+		initBrickPositions(bricks, LAYERS, BRICKS_PER_LAYER, BRICK_WIDTH, BRICK_HEIGHT, BRICK_HORIZ_PADDING, BRICK_VERT_PADDING);
+		benchmark::DoNotOptimize(bricks);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_InitBrickPositions);
+
+static void BM_ResetBrickMap(benchmark::State& state) {
+	BrickState brickStates[BRICKS_COUNT];
+	for (auto _ : state) {
+		ResetBrickMap(brickStates);
+		benchmark::DoNotOptimize(brickStates);
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_ResetBrickMap);
+
+static void BM_ScoreLookup(benchmark::State& state) {
+	int brickIndex = 0;
+	for (auto _ : state) {
+		int layerIndex = brickIndex / BRICKS_PER_LAYER;
+		benchmark::DoNotOptimize(getScoresTable().at((ColorLabel)layerIndex));
+		brickIndex = (brickIndex + 1) % BRICKS_COUNT;
+	}
+}
+BENCHMARK(BM_ScoreLookup);
+
+// One full headless simulation step at the target frame rate with the paddle following the ball
+static void BM_StepGame(benchmark::State& state) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	srand(1);
+	GameState game;
+	InitGame(&game);
+
+	for (auto _ : state) {
+		int paddleCenter = game.paddle.x + game.paddle.w / 2;
+		int ballCenter = game.ball.x + game.ball.w / 2;
+		GameInput input{ ballCenter > paddleCenter ? timeDelta : -timeDelta, false, game.isGameOver };
+		benchmark::DoNotOptimize(StepGame(&game, input, timeDelta));
+	}
+}
+BENCHMARK(BM_StepGame);
+
+// Ball travel (pixels) per second of display time, frames at refreshRate Hz stepped like the vsync frame loop
+static double SimulateBallTravel(int refreshRate, int seconds) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	GameState game;
+	InitSeededGame(&game, 1);
+	FixedStepClock clock{ 0.0 };
+	double travel = 0.0;
+	for (int frame = 0; frame < refreshRate * seconds; ++frame) {
+		int steps = AdvanceFixedStepClock(&clock, 1000.0 / refreshRate);
+		for (int step = 0; step < steps; ++step) {
+			SDL_Rect ball = game.ball;
+			int paddleCenter = game.paddle.x + game.paddle.w / 2;
+			int ballCenter = game.ball.x + game.ball.w / 2;
+			GameInput input{ ballCenter > paddleCenter ? timeDelta : -timeDelta, false, game.isGameOver };
+			StepGame(&game, input, timeDelta);
+			travel += abs(game.ball.x - ball.x) + abs(game.ball.y - ball.y);
+		}
+	}
+	return travel / seconds;
+}
+
+// range(0) is the display's refresh rate. The ball moves whole pixels per step, so the game has to step at a fixed
+// rate however fast the display is, fails if the ball is more than 1% faster or slower than at 60 Hz
+static void BM_FixedStepsAtRefreshRate(benchmark::State& state) {
+	const int seconds = 10;
+	static const double travelAt60Hz = SimulateBallTravel(60, seconds);
+	double travel = 0.0;
+	for (auto _ : state) {
+		travel = SimulateBallTravel((int)state.range(0), seconds);
+		benchmark::DoNotOptimize(travel);
+	}
+	state.counters["ball_px_per_s"] = travel;
+	if (travel < travelAt60Hz * 0.99 || travel > travelAt60Hz * 1.01) {
+		state.SkipWithError("the ball's speed depends on the refresh rate");
+	}
+}
+BENCHMARK(BM_FixedStepsAtRefreshRate)->Arg(60)->Arg(75)->Arg(120)->Arg(144)->Arg(165)->Arg(240);
+
+// StepGame() with every power-up in effect: two extra balls, the wide paddle, the laser firing and a few power-ups
+// falling, all given again whenever they run out
+static void BM_StepGameWithPowerUps(benchmark::State& state) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	GameState game;
+	InitSeededGame(&game, 1);
+
+	for (auto _ : state) {
+		if (game.extraBallCount == 0 || game.entities.count < 4) {
+			state.PauseTiming();
+			for (int kind = 0; kind < POWER_UP_KIND_COUNT; ++kind) {
+				SpawnEntity(&game.entities, (EntityKind)kind, game.paddle.x, game.paddle.y);
+			}
+			SpawnEntity(&game.entities, EntityKind::WIDE_PADDLE, game.paddle.x, CEILING_OFFSET);
+			state.ResumeTiming();
+		}
+		int paddleCenter = game.paddle.x + game.paddle.w / 2;
+		int ballCenter = game.ball.x + game.ball.w / 2;
+		GameInput input{ ballCenter > paddleCenter ? timeDelta : -timeDelta, false, game.isGameOver };
+		benchmark::DoNotOptimize(StepGame(&game, input, timeDelta));
+	}
+}
+BENCHMARK(BM_StepGameWithPowerUps);
+
+// the catch test over a full pool of falling power-ups, half of them on the paddle
+static void BM_FindCaughtPowerUps(benchmark::State& state) {
+	const SDL_Rect paddle { (GAME_WIDTH - PADDLE_WIDTH) / 2, GAME_HEIGHT - PADDLE_HEIGHT - 20, PADDLE_WIDTH, PADDLE_HEIGHT };
+	EntityPool pool;
+	ClearEntities(&pool);
+	for (int i = 0; i < MAX_ENTITIES; ++i) {
+		int y = i % 2 == 0 ? paddle.y : CEILING_OFFSET;
+		SpawnEntity(&pool, (EntityKind)(i % POWER_UP_KIND_COUNT), paddle.x + (i - MAX_ENTITIES / 2) * 12, y);
+	}
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(FindCaughtPowerUps(pool, paddle));
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_FindCaughtPowerUps);
+
+// Batched environment steps with the paddle following the ball, range(0) games per batch.
+// items_per_second is the number of game steps per second
+static void BM_EnvStep(benchmark::State& state) {
+	int envCount = (int)state.range(0);
+	BreakoutEnvBatch* batch = BreakoutEnvCreate(envCount, 1, 0);
+	std::vector<float> observations(envCount * BREAKOUT_ENV_OBSERVATION_SIZE);
+	std::vector<float> rewards(envCount);
+	std::vector<uint8_t> dones(envCount);
+	std::vector<int32_t> actions(envCount);
+	BreakoutEnvReset(batch, 1, observations.data());
+
+	for (auto _ : state) {
+		for (int i = 0; i < envCount; ++i) {
+			const float* observation = &observations[i * BREAKOUT_ENV_OBSERVATION_SIZE];
+			float ballCenter = observation[BREAKOUT_ENV_BALL_X] + BALL_WIDTH / 2.0f / GAME_WIDTH;
+			float paddleCenter = observation[BREAKOUT_ENV_PADDLE_X] + PADDLE_WIDTH / 2.0f / GAME_WIDTH;
+			actions[i] = ballCenter > paddleCenter ? BREAKOUT_ENV_RIGHT : BREAKOUT_ENV_LEFT;
+		}
+		BreakoutEnvStep(batch, actions.data(), observations.data(), rewards.data(), dones.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * envCount);
+	BreakoutEnvDestroy(batch);
+}
+BENCHMARK(BM_EnvStep)->Arg(1)->Arg(64)->Arg(1024);
+
+// Worst case for the autopilot: the ball just left the paddle and goes all the way up through the bricks and back
+static void BM_PredictBallLanding(benchmark::State& state) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	GameState game;
+	InitSeededGame(&game, 1);
+	game.ball.y = game.paddle.y - game.ball.h - 1;
+	game.yDirection = -1;
+
+	int landingX = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(PredictBallLanding(game, timeDelta, &landingX));
+	}
+}
+BENCHMARK(BM_PredictBallLanding);
+
+// one search node: clone a game and step it one frame, the way tools/levelSolver.cpp expands its beam
+static void BM_StepCompactGame(benchmark::State& state) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	GameState game;
+	InitSeededGame(&game, 1);
+	CompactGame root;
+	PackGame(game, &root);
+
+	CompactGame clone;
+	for (auto _ : state) {
+		clone = root;
+		benchmark::DoNotOptimize(StepCompactGame(&clone, timeDelta, timeDelta));
+		benchmark::DoNotOptimize(clone);
+	}
+}
+BENCHMARK(BM_StepCompactGame);
+
+static void BM_StepGameCopy(benchmark::State& state) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	GameState game;
+	InitSeededGame(&game, 1);
+	GameInput input{ timeDelta, false, false };
+
+	GameState clone;
+	for (auto _ : state) {
+		clone = game;
+		StepGame(&clone, input, timeDelta);
+		benchmark::DoNotOptimize(clone);
+	}
+}
+BENCHMARK(BM_StepGameCopy);
+
+const int OBSERVATION_WIDTH = 84;
+const int OBSERVATION_HEIGHT = 84;
+
+// a game halfway through, every third brick gone
+static void InitHalfwayGame(GameState* game) {
+	InitSeededGame(game, 1);
+	for (int i = 0; i < BRICKS_COUNT; i += 3) {
+		game->brickStates[i] = DamageBrick(game->brickStates[i]);
+	}
+}
+
+static void BM_RenderObservation(benchmark::State& state) {
+	GameState game;
+	InitHalfwayGame(&game);
+	std::vector<float> scratch(OBSERVATION_WIDTH * OBSERVATION_HEIGHT);
+	std::vector<Uint8> pixels(OBSERVATION_WIDTH * OBSERVATION_HEIGHT);
+
+	for (auto _ : state) {
+		RenderObservation(game, OBSERVATION_WIDTH, OBSERVATION_HEIGHT, scratch.data(), pixels.data());
+		benchmark::DoNotOptimize(pixels.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_RenderObservation);
+
+static void FillRect(Uint8* frame, const SDL_Rect& rect, Uint8 value) {
+	for (int y = SDL_max(rect.y, 0); y < SDL_min(rect.y + rect.h, GAME_HEIGHT); ++y) {
+		for (int x = SDL_max(rect.x, 0); x < SDL_min(rect.x + rect.w, GAME_WIDTH); ++x) {
+			frame[y * GAME_WIDTH + x] = value;
+		}
+	}
+}
+
+// What RenderObservation() replaces: drawing the whole frame and box filtering it down
+static void BM_RenderFullFrameAndDownsample(benchmark::State& state) {
+	GameState game;
+	InitHalfwayGame(&game);
+	std::vector<Uint8> frame(GAME_WIDTH * GAME_HEIGHT);
+	std::vector<Uint8> pixels(OBSERVATION_WIDTH * OBSERVATION_HEIGHT);
+
+	for (auto _ : state) {
+		std::fill(frame.begin(), frame.end(), 0);
+		for (int i = 0; i < BRICKS_COUNT; ++i) {
+			if (GetBrickHitPoints(game.brickStates[i]) != 0) {
+				const SDL_Color& color = GetBrickPalette()[game.brickStates[i]];
+				FillRect(frame.data(), game.bricks[i], (Uint8)((299 * color.r + 587 * color.g + 114 * color.b) / 1000));
+			}
+		}
+		FillRect(frame.data(), game.paddle, 255);
+		FillRect(frame.data(), game.ball, 255);
+
+		for (int y = 0; y < OBSERVATION_HEIGHT; ++y) {
+			int top = y * GAME_HEIGHT / OBSERVATION_HEIGHT;
+			int bottom = (y + 1) * GAME_HEIGHT / OBSERVATION_HEIGHT;
+			for (int x = 0; x < OBSERVATION_WIDTH; ++x) {
+				int left = x * GAME_WIDTH / OBSERVATION_WIDTH;
+				int right = (x + 1) * GAME_WIDTH / OBSERVATION_WIDTH;
+				int sum = 0;
+				for (int sourceY = top; sourceY < bottom; ++sourceY) {
+					for (int sourceX = left; sourceX < right; ++sourceX) {
+						sum += frame[sourceY * GAME_WIDTH + sourceX];
+					}
+				}
+				pixels[y * OBSERVATION_WIDTH + x] = (Uint8)(sum / ((bottom - top) * (right - left)));
+			}
+		}
+		benchmark::DoNotOptimize(pixels.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_RenderFullFrameAndDownsample);
+
+// 84 x 84 observations of a batch of 1024 games, range(0) threads. items_per_second is images per second
+static void BM_EnvRender(benchmark::State& state) {
+	const int envCount = 1024;
+	BreakoutEnvBatch* batch = BreakoutEnvCreate(envCount, 1, 0);
+	std::vector<uint8_t> pixels(envCount * OBSERVATION_WIDTH * OBSERVATION_HEIGHT);
+
+	for (auto _ : state) {
+		BreakoutEnvRender(batch, OBSERVATION_WIDTH, OBSERVATION_HEIGHT, pixels.data(), (int)state.range(0));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * envCount);
+	BreakoutEnvDestroy(batch);
+}
+BENCHMARK(BM_EnvRender)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+BENCHMARK_MAIN();
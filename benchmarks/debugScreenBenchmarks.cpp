@@ -0,0 +1,179 @@
+// Microbenchmarks for the PS Vita debug screen (psvita/common/debugScreen.c)
+// Off the Vita it draws into its static framebuffer instead of display memory, so the text blitter can be measured here
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "debugScreen.h"
+#include "referenceDebugScreen.h"
+
+static const char LOG_LINE[] = "Ball hit brick 42 at (480, 272), score 120, lives 3, frame time 16.6 ms\n";
+
+static void BM_DebugScreenPuts(benchmark::State& state) {
+	psvDebugScreenInit();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPuts(LOG_LINE));
+	}
+	state.SetItemsProcessed(state.iterations() * (sizeof(LOG_LINE) - 1));
+}
+BENCHMARK(BM_DebugScreenPuts);
+
+// known length, plain text is found 8 bytes at a time and written to the cells a line at a time
+static void BM_DebugScreenPutsN(benchmark::State& state) {
+	psvDebugScreenInit();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPutsN(LOG_LINE, sizeof(LOG_LINE) - 1));
+	}
+	state.SetItemsProcessed(state.iterations() * (sizeof(LOG_LINE) - 1));
+}
+BENCHMARK(BM_DebugScreenPutsN);
+
+// every glyph with the 2x scaled font (16x16 pixels)
+static void BM_DebugScreenPutsScaled(benchmark::State& state) {
+	psvDebugScreenInit();
+	PsvDebugScreenFont* font = psvDebugScreenGetFont();
+	PsvDebugScreenFont* scaledFont = psvDebugScreenScaleFont2x(font);
+	psvDebugScreenSetFont(scaledFont);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPuts(LOG_LINE));
+	}
+	state.SetItemsProcessed(state.iterations() * (sizeof(LOG_LINE) - 1));
+	psvDebugScreenSetFont(font);
+	free(scaledFont->glyphs);
+	free(scaledFont);
+}
+BENCHMARK(BM_DebugScreenPutsScaled);
+
+// color changes in between the text, like colored log levels
+static void BM_DebugScreenPutsColored(benchmark::State& state) {
+	psvDebugScreenInit();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPuts("\e[31m[ERROR]\e[0m brick map out of sync\n\e[32m[INFO]\e[0m level cleared\n"));
+	}
+}
+BENCHMARK(BM_DebugScreenPutsColored);
+
+// status line rewritten in place, only the changed digits are redrawn
+static void BM_DebugScreenStatusLine(benchmark::State& state) {
+	psvDebugScreenInit();
+	int frame = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPrintf("\e[1;1Hframe %6d score %4d lives %d", frame, frame / 60, 3));
+		++frame;
+	}
+}
+BENCHMARK(BM_DebugScreenStatusLine);
+
+static void BM_DebugScreenClear(benchmark::State& state) {
+	psvDebugScreenInit();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPuts("\e[H\e[2J"));
+	}
+}
+BENCHMARK(BM_DebugScreenClear);
+
+// synchronous printf, formats and draws on the calling thread
+static void BM_DebugScreenPrintf(benchmark::State& state) {
+	psvDebugScreenInit();
+	int frame = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(psvDebugScreenPrintf("frame %d: ball at (%d, %d), score %d\n", frame, frame % 960, frame % 544, frame / 60));
+		++frame;
+	}
+}
+BENCHMARK(BM_DebugScreenPrintf);
+
+static std::atomic<bool> isLogConsumerRunning;
+static std::thread logConsumer;
+static std::atomic<long> loggedBytes;
+
+static void CountLogBytes(const char* text, int length, void* context) {
+	loggedBytes.fetch_add(length, std::memory_order_relaxed);
+}
+
+// producers on every benchmark thread log through the lock-free queue,
+// a consumer thread drains it like the frame loop would (into a counter, not the screen).
+// A producer that finds the queue full yields and tries again, so every iteration is one message logged and
+// drained and items_per_second is the logging throughput. queue_full is the failed attempts per message
+static void BM_DebugScreenLogPrintf(benchmark::State& state) {
+	if (state.thread_index() == 0) {
+		psvDebugScreenInit();
+		loggedBytes = 0;
+		isLogConsumerRunning = true;
+		logConsumer = std::thread([] {
+			while (isLogConsumerRunning) {
+				if (psvDebugScreenLogDrain(CountLogBytes, NULL) == 0) {
+					std::this_thread::yield();
+				}
+			}
+			psvDebugScreenLogDrain(CountLogBytes, NULL);
+		});
+	}
+
+	long fullCount = 0;
+	int frame = 0;
+	for (auto _ : state) {
+		while (psvDebugScreenLogPrintf("thread %d frame %d: ball at (%d, %d)\n", state.thread_index(), frame, frame % 960, frame % 544) < 0) {
+			++fullCount;
+			std::this_thread::yield();
+		}
+		++frame;
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.counters["queue_full"] = benchmark::Counter((double)fullCount, benchmark::Counter::kAvgIterations);
+
+	if (state.thread_index() == 0) {
+		isLogConsumerRunning = false;
+		logConsumer.join();
+		state.SetBytesProcessed(loggedBytes);
+	}
+}
+BENCHMARK(BM_DebugScreenLogPrintf)->Threads(1)->Threads(2)->Threads(4)->UseRealTime();
+
+// queued messages drained to the screen once per frame
+static void BM_DebugScreenLogDrain(benchmark::State& state) {
+	psvDebugScreenInit();
+	int frame = 0;
+	for (auto _ : state) {
+		for (int i = 0; i < state.range(0); ++i) {
+			psvDebugScreenLogPrintf("frame %d: ball at (%d, %d), score %d\n", frame, frame % 960, frame % 544, i);
+		}
+		benchmark::DoNotOptimize(psvDebugScreenLogDrain(NULL, NULL));
+		++frame;
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DebugScreenLogDrain)->Arg(1)->Arg(16);
+
+static void FreeFont(PsvDebugScreenFont* font) {
+	free(font->glyphs);
+	free(font);
+}
+
+// the original bit by bit psvDebugScreenScaleFont2x() to compare psvDebugScreenScaleFontNx() with
+static void BM_ScaleFont2xReference(benchmark::State& state) {
+	PsvDebugScreenFont* font = psvDebugScreenGetFont();
+	for (auto _ : state) {
+		PsvDebugScreenFont* scaledFont = referenceDebugScreenScaleFont2x(font);
+		benchmark::DoNotOptimize(scaledFont->glyphs);
+		FreeFont(scaledFont);
+	}
+}
+BENCHMARK(BM_ScaleFont2xReference);
+
+// range(0) is the scale factor
+static void BM_ScaleFontNx(benchmark::State& state) {
+	PsvDebugScreenFont* font = psvDebugScreenGetFont();
+	for (auto _ : state) {
+		PsvDebugScreenFont* scaledFont = psvDebugScreenScaleFontNx(font, state.range(0));
+		benchmark::DoNotOptimize(scaledFont->glyphs);
+		FreeFont(scaledFont);
+	}
+}
+BENCHMARK(BM_ScaleFontNx)->Arg(2)->Arg(3)->Arg(4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,341 @@
+// Frame-time regression harness
+// Replays a recorded session (see core/inputScript.h, record one with `breakout_clone --record <file>`)
+// through the full frame loop: input, simulation, UI + game drawing and presentation.
+// Runs headless with SDL's dummy video driver (or offscreen, set SDL_VIDEODRIVER) and the software renderer,
+// prints frames per second, frame time percentiles, per phase timings and allocations per frame,
+// and exits with 1 if one of the given thresholds is exceeded.
+// Soak runs play with the autopilot instead of a session for as long as asked, printing a report every
+// --report-every seconds (frame time percentiles, allocations and live allocations, which keep growing with a leak).
+// --paced sleeps to the target frame rate like the game loop, so the reports show pacing.
+// --window and --render-scale draw through a RenderScaler (core/renderScaler.h) like the game does, to weigh
+// the fill rate saved at a lower render scale against a larger window.
+//
+// usage: frame_harness <session> [--res <dir>] [--repeat <n>] [--window <width>x<height>] [--render-scale <scale>]
+//                      [--max-p99-ms <ms>] [--min-fps <fps>] [--max-allocs-per-frame <n>]
+//        frame_harness --autopilot <minutes> [--report-every <seconds>] [--paced] [--res <dir>] [--window ...] [--render-scale ...] [thresholds]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "allocationCounter.h"
+#include "autopilot.h"
+#include "frameProfiler.h"
+#include "game.h"
+#include "gameRenderer.h"
+#include "inputScript.h"
+#include "renderScaler.h"
+
+struct HarnessOptions {
+	const char* sessionPath;
+	std::string resourcePath;
+	int repeat;
+	// soak runs
+	double autopilotMinutes;
+	double reportSeconds;
+	bool isPaced;
+	int windowWidth;
+	int windowHeight;
+	float renderScale;
+	// thresholds, negative values are not checked
+	double maxP99Millis;
+	double minFramesPerSecond;
+	double maxAllocationsPerFrame;
+};
+
+static void PrintUsage() {
+	fprintf(stderr, "usage: frame_harness <session> [--res <dir>] [--repeat <n>] [--window <width>x<height>] [--render-scale <scale>] "
+		"[--max-p99-ms <ms>] [--min-fps <fps>] [--max-allocs-per-frame <n>]\n"
+		"       frame_harness --autopilot <minutes> [--report-every <seconds>] [--paced] [--res <dir>] [--window <width>x<height>] "
+		"[--render-scale <scale>] [--max-p99-ms <ms>] [--min-fps <fps>] [--max-allocs-per-frame <n>]\n");
+}
+
+static bool ParseOptions(int argc, char** argv, HarnessOptions* options) {
+	options->sessionPath = NULL;
+	options->repeat = 1;
+	options->autopilotMinutes = 0.0;
+	options->reportSeconds = 60.0;
+	options->isPaced = false;
+	options->windowWidth = GAME_WIDTH;
+	options->windowHeight = GAME_HEIGHT;
+	options->renderScale = 1.0f;
+	options->maxP99Millis = -1.0;
+	options->minFramesPerSecond = -1.0;
+	options->maxAllocationsPerFrame = -1.0;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		bool hasValue = i + 1 < argc;
+		if (arg == "--res" && hasValue) {
+			options->resourcePath = argv[++i];
+		}
+		else if (arg == "--repeat" && hasValue) {
+			options->repeat = atoi(argv[++i]);
+		}
+		else if (arg == "--autopilot" && hasValue) {
+			options->autopilotMinutes = atof(argv[++i]);
+		}
+		else if (arg == "--report-every" && hasValue) {
+			options->reportSeconds = atof(argv[++i]);
+		}
+		else if (arg == "--paced") {
+			options->isPaced = true;
+		}
+		else if (arg == "--window" && hasValue) {
+			if (sscanf(argv[++i], "%dx%d", &options->windowWidth, &options->windowHeight) != 2) {
+				return false;
+			}
+		}
+		else if (arg == "--render-scale" && hasValue) {
+			options->renderScale = (float)atof(argv[++i]);
+		}
+		else if (arg == "--max-p99-ms" && hasValue) {
+			options->maxP99Millis = atof(argv[++i]);
+		}
+		else if (arg == "--min-fps" && hasValue) {
+			options->minFramesPerSecond = atof(argv[++i]);
+		}
+		else if (arg == "--max-allocs-per-frame" && hasValue) {
+			options->maxAllocationsPerFrame = atof(argv[++i]);
+		}
+		else if (options->sessionPath == NULL && arg.compare(0, 2, "--") != 0) {
+			options->sessionPath = argv[i];
+		}
+		else {
+			return false;
+		}
+	}
+
+	if (options->resourcePath.empty()) {
+		// res/ is copied next to the executable by the build
+		char* basePath = SDL_GetBasePath();
+		if (basePath) {
+			options->resourcePath = std::string(basePath) + "res/";
+			SDL_free(basePath);
+		}
+	}
+	else if (options->resourcePath[options->resourcePath.size() - 1] != '/') {
+		options->resourcePath += '/';
+	}
+
+	bool isSoak = options->autopilotMinutes > 0.0;
+	return (options->sessionPath != NULL) != isSoak && options->repeat > 0 && options->reportSeconds > 0.0 &&
+		options->windowWidth > 0 && options->windowHeight > 0 && options->renderScale >= MIN_RENDER_SCALE && options->renderScale <= 1.0f;
+}
+
+// returns false if the value exceeded its threshold
+static bool CheckThreshold(const char* name, double value, double threshold, bool isMaximum) {
+	if (threshold < 0.0) {
+		return true;
+	}
+
+	bool passed = isMaximum ? value <= threshold : value >= threshold;
+	printf("%s %s: %.3f (%s %.3f)\n", passed ? "PASS" : "FAIL", name, value, isMaximum ? "max" : "min", threshold);
+	return passed;
+}
+
+static bool ReplaySession(SDL_Renderer* renderer, const RenderScaler& scaler, GameLabels* labels, TTF_Font* font, const InputScript& script, const HarnessOptions& options) {
+	printf("session: %s (%zu frames, seed %u) x %d using the %s video driver\n",
+		options.sessionPath, script.frames.size(), script.seed, options.repeat, SDL_GetCurrentVideoDriver());
+
+	FrameProfiler profiler;
+	InitFrameProfiler(&profiler, script.frames.size() * options.repeat);
+
+	GameState game;
+	for (int run = 0; run < options.repeat; ++run) {
+		srand(script.seed);
+		InitGame(&game);
+
+		for (size_t frame = 0; frame < script.frames.size(); ++frame) {
+			BeginFrame(&profiler);
+
+			SDL_Event e;
+			while (SDL_PollEvent(&e) > 0) {
+			}
+			const RecordedFrame& recorded = script.frames[frame];
+			EndPhase(&profiler, PHASE_INPUT);
+
+			StepGame(&game, recorded.input, recorded.timeDelta);
+			EndPhase(&profiler, PHASE_SIMULATE);
+
+			BeginScaledFrame(scaler, renderer);
+			DrawUI(renderer, labels, UIFont{ font, NULL, NULL, NULL }, game);
+			DrawGame(renderer, game);
+			EndScaledFrame(scaler, renderer);
+			EndPhase(&profiler, PHASE_DRAW);
+
+			SDL_RenderPresent(renderer);
+			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+			SDL_RenderClear(renderer);
+			EndPhase(&profiler, PHASE_PRESENT);
+
+			EndFrame(&profiler);
+		}
+	}
+
+	FrameReport report = BuildFrameReport(profiler);
+	PrintFrameReport(report);
+	printf("final score: %d, lives: %d\n", game.score, game.lives);
+
+	bool passed = true;
+	passed &= CheckThreshold("p99 frame time (ms)", report.p99FrameMillis, options.maxP99Millis, true);
+	passed &= CheckThreshold("frames per second", report.framesPerSecond, options.minFramesPerSecond, false);
+	passed &= CheckThreshold("allocations per frame", report.allocationsPerFrame, options.maxAllocationsPerFrame, true);
+	return passed;
+}
+
+// Prints a report every options.reportSeconds, the thresholds are checked against the worst one
+static bool RunSoak(SDL_Renderer* renderer, const RenderScaler& scaler, GameLabels* labels, TTF_Font* font, const HarnessOptions& options) {
+	const float timeDelta = TARGET_MILLIS_PER_FRAME / (float)1000;
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 now = SDL_GetPerformanceCounter();
+	Uint64 soakStart = now;
+	Uint64 soakEnd = now + (Uint64)(options.autopilotMinutes * 60.0 * frequency);
+	Uint64 reportInterval = (Uint64)(options.reportSeconds * frequency);
+	Uint64 nextReport = now + reportInterval;
+
+	printf("soak: autopilot for %.1f minutes%s using the %s video driver, reporting every %.0f s\n", options.autopilotMinutes,
+		options.isPaced ? " paced to the target frame rate" : "", SDL_GetCurrentVideoDriver(), options.reportSeconds);
+
+	// a report's worth of samples, cleared after every report so hours of samples are not kept around
+	FrameProfiler profiler;
+	InitFrameProfiler(&profiler, (size_t)(options.reportSeconds * TARGET_FRAME_RATE * 2));
+
+	GameState game;
+	InitSeededGame(&game, 1);
+	int games = 1;
+	int liveAllocationsAtStart = GetLiveAllocationCount();
+	double maxP99Millis = 0.0;
+	double minFramesPerSecond = -1.0;
+	double maxAllocationsPerFrame = 0.0;
+	while (now < soakEnd) {
+		BeginFrame(&profiler);
+
+		SDL_Event e;
+		while (SDL_PollEvent(&e) > 0) {
+		}
+		EndPhase(&profiler, PHASE_INPUT);
+
+		GameInput input = GetAutopilotInput(game, timeDelta);
+		games += input.restart ? 1 : 0;
+		StepGame(&game, input, timeDelta);
+		EndPhase(&profiler, PHASE_SIMULATE);
+
+		BeginScaledFrame(scaler, renderer);
+		DrawUI(renderer, labels, UIFont{ font, NULL, NULL, NULL }, game);
+		DrawGame(renderer, game);
+		EndScaledFrame(scaler, renderer);
+		EndPhase(&profiler, PHASE_DRAW);
+
+		SDL_RenderPresent(renderer);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderClear(renderer);
+		EndPhase(&profiler, PHASE_PRESENT);
+
+		// like the game loop, the sleep counts towards the frame time but not towards a phase
+		if (options.isPaced) {
+			Uint32 elapsedMillis = (Uint32)((SDL_GetPerformanceCounter() - profiler.frameStart) * 1000 / frequency);
+			if (elapsedMillis < TARGET_MILLIS_PER_FRAME) {
+				SDL_Delay(TARGET_MILLIS_PER_FRAME - elapsedMillis);
+			}
+		}
+		EndFrame(&profiler);
+
+		now = SDL_GetPerformanceCounter();
+		if (now >= nextReport || now >= soakEnd) {
+			FrameReport report = BuildFrameReport(profiler);
+			printf("%7.0f s %7zu frames %7.1f fps  p50 %6.2f ms  p99 %6.2f ms  max %6.2f ms  %5.2f allocs/frame  %6d live allocations  game %d score %d\n",
+				(now - soakStart) / (double)frequency, report.frames, report.framesPerSecond, report.p50FrameMillis, report.p99FrameMillis,
+				report.maxFrameMillis, report.allocationsPerFrame, GetLiveAllocationCount(), games, game.score);
+			fflush(stdout);
+
+			maxP99Millis = SDL_max(maxP99Millis, report.p99FrameMillis);
+			minFramesPerSecond = minFramesPerSecond < 0.0 ? report.framesPerSecond : SDL_min(minFramesPerSecond, report.framesPerSecond);
+			maxAllocationsPerFrame = SDL_max(maxAllocationsPerFrame, report.allocationsPerFrame);
+			profiler.samples.clear();
+			nextReport += reportInterval;
+		}
+	}
+
+	printf("live allocations: %d at the start, %d at the end\n", liveAllocationsAtStart, GetLiveAllocationCount());
+
+	bool passed = true;
+	passed &= CheckThreshold("worst p99 frame time (ms)", maxP99Millis, options.maxP99Millis, true);
+	passed &= CheckThreshold("worst frames per second", minFramesPerSecond, options.minFramesPerSecond, false);
+	passed &= CheckThreshold("worst allocations per frame", maxAllocationsPerFrame, options.maxAllocationsPerFrame, true);
+	return passed;
+}
+
+int main(int argc, char** argv) {
+	HarnessOptions options;
+	if (!ParseOptions(argc, argv, &options)) {
+		PrintUsage();
+		return 2;
+	}
+
+	InputScript script;
+	if (options.sessionPath != NULL && (!LoadInputScript(options.sessionPath, &script) || script.frames.empty())) {
+		fprintf(stderr, "Unable to load session: %s\n", options.sessionPath);
+		return 2;
+	}
+
+	// counts SDL's allocations too, so it has to be installed before SDL allocates anything
+	InstallAllocationCounter();
+
+	// headless by default, SDL_VIDEODRIVER=offscreen (or a real driver) can still be chosen from the environment
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+		fprintf(stderr, "Error Initializing SDL: %s\n", SDL_GetError());
+		return 2;
+	}
+
+	if (TTF_Init() == -1) {
+		fprintf(stderr, "Error Initializing SDL_TTF: %s\n", TTF_GetError());
+		return 2;
+	}
+
+	std::string fontPath(options.resourcePath + "font.otf");
+	TTF_Font* font = TTF_OpenFont(fontPath.c_str(), 28);
+	TTF_Font* bigFont = TTF_OpenFont(fontPath.c_str(), 48);
+	if (font == NULL || bigFont == NULL) {
+		fprintf(stderr, "Unable to load font: %s\n", TTF_GetError());
+		return 2;
+	}
+
+	SDL_Window* window = SDL_CreateWindow("Breakout Clone Harness", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+		options.windowWidth, options.windowHeight, SDL_WINDOW_HIDDEN);
+	SDL_Renderer* renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE) : NULL;
+	if (renderer == NULL) {
+		fprintf(stderr, "Error creating software renderer: %s\n", SDL_GetError());
+		return 2;
+	}
+
+	RenderScaler scaler;
+	if (!InitRenderScaler(&scaler, renderer, options.renderScale)) {
+		fprintf(stderr, "Error scaling the rendering: %s\n", SDL_GetError());
+		return 2;
+	}
+	printf("rendering %dx%d for a %dx%d window\n", scaler.target ? scaler.targetWidth : scaler.outputWidth,
+		scaler.target ? scaler.targetHeight : scaler.outputHeight, scaler.outputWidth, scaler.outputHeight);
+
+	GameLabels labels;
+	CreateGameLabels(renderer, &labels, font, bigFont, "Press Spacebar to Play Again", "Press P to Unpause");
+
+	bool passed = options.sessionPath != NULL ? ReplaySession(renderer, scaler, &labels, font, script, options) :
+		RunSoak(renderer, scaler, &labels, font, options);
+
+	DestroyGameLabels(&labels);
+	DestroyRenderScaler(&scaler);
+	SDL_DestroyRenderer(renderer);
+	SDL_DestroyWindow(window);
+	TTF_CloseFont(font);
+	TTF_CloseFont(bigFont);
+	TTF_Quit();
+	SDL_Quit();
+
+	return passed ? 0 : 1;
+}
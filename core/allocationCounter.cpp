@@ -0,0 +1,90 @@
+#include "allocationCounter.h"
+
+#include <stdlib.h>
+
+#include <new>
+
+static SDL_atomic_t allocationCount;
+static SDL_atomic_t liveAllocationCount;
+
+static SDL_malloc_func originalMalloc;
+static SDL_calloc_func originalCalloc;
+static SDL_realloc_func originalRealloc;
+static SDL_free_func originalFree;
+
+static void* SDLCALL CountingMalloc(size_t size) {
+	SDL_AtomicAdd(&allocationCount, 1);
+	void* mem = originalMalloc(size);
+	if (mem != NULL) {
+		SDL_AtomicAdd(&liveAllocationCount, 1);
+	}
+	return mem;
+}
+
+static void* SDLCALL CountingCalloc(size_t count, size_t size) {
+	SDL_AtomicAdd(&allocationCount, 1);
+	void* mem = originalCalloc(count, size);
+	if (mem != NULL) {
+		SDL_AtomicAdd(&liveAllocationCount, 1);
+	}
+	return mem;
+}
+
+static void* SDLCALL CountingRealloc(void* mem, size_t size) {
+	SDL_AtomicAdd(&allocationCount, 1);
+	void* newMem = originalRealloc(mem, size);
+	// only a new block when there was none before
+	if (mem == NULL && newMem != NULL) {
+		SDL_AtomicAdd(&liveAllocationCount, 1);
+	}
+	// a size of 0 frees the block (unless a new minimal one is returned)
+	else if (mem != NULL && size == 0 && newMem == NULL) {
+		SDL_AtomicAdd(&liveAllocationCount, -1);
+	}
+	return newMem;
+}
+
+static void SDLCALL CountingFree(void* mem) {
+	if (mem != NULL) {
+		SDL_AtomicAdd(&liveAllocationCount, -1);
+	}
+	originalFree(mem);
+}
+
+void InstallAllocationCounter() {
+	SDL_GetMemoryFunctions(&originalMalloc, &originalCalloc, &originalRealloc, &originalFree);
+	SDL_SetMemoryFunctions(CountingMalloc, CountingCalloc, CountingRealloc, CountingFree);
+}
+
+Uint32 GetAllocationCount() {
+	return (Uint32)SDL_AtomicGet(&allocationCount);
+}
+
+int GetLiveAllocationCount() {
+	return SDL_AtomicGet(&liveAllocationCount);
+}
+
+void* operator new(size_t size) {
+	SDL_AtomicAdd(&allocationCount, 1);
+	void* mem = malloc(size ? size : 1);
+	if (mem == NULL) {
+		throw std::bad_alloc();
+	}
+	SDL_AtomicAdd(&liveAllocationCount, 1);
+	return mem;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* mem) noexcept {
+	if (mem != NULL) {
+		SDL_AtomicAdd(&liveAllocationCount, -1);
+	}
+	free(mem);
+}
+
+void operator delete[](void* mem) noexcept {
+	operator delete(mem);
+}
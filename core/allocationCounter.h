@@ -0,0 +1,18 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <SDL.h>
+
+// Counts heap allocations made through operator new and through SDL's allocator
+// (which SDL_ttf and the renderers use as well). Linking this file replaces the global operator new/delete.
+
+// Routes SDL's malloc/calloc/realloc through the counter, must be called before SDL_Init
+void InstallAllocationCounter();
+
+// Number of allocations made since the program started
+Uint32 GetAllocationCount();
+
+// Allocations not freed yet (made since InstallAllocationCounter() for SDL's allocator), keeps growing with a leak
+int GetLiveAllocationCount();
+
+#endif
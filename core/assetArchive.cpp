@@ -0,0 +1,175 @@
+#include "assetArchive.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__vita__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(AssetArchiveHeader) == 16, "archive header layout");
+static_assert(sizeof(AssetArchiveEntry) == 64, "archive entry layout");
+
+#if defined(_WIN32)
+static bool MapArchive(const char* path, AssetArchive* archive) {
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (view == NULL) {
+		if (mapping) {
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		return false;
+	}
+
+	archive->data = (const unsigned char*)view;
+	archive->size = (size_t)size.QuadPart;
+	archive->isMapped = true;
+	archive->file = file;
+	archive->mapping = mapping;
+	return true;
+}
+
+static void UnmapArchive(AssetArchive* archive) {
+	UnmapViewOfFile(archive->data);
+	CloseHandle(archive->mapping);
+	CloseHandle(archive->file);
+}
+#elif defined(__vita__)
+// no mmap for application files, read the whole archive with a single read instead
+static bool MapArchive(const char* path, AssetArchive* archive) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+	unsigned char* data = size > 0 ? (unsigned char*)malloc(size) : NULL;
+	bool isRead = data != NULL && fseek(file, 0, SEEK_SET) == 0 && fread(data, 1, size, file) == (size_t)size;
+	fclose(file);
+	if (!isRead) {
+		free(data);
+		return false;
+	}
+
+	archive->data = data;
+	archive->size = (size_t)size;
+	archive->isMapped = false;
+	return true;
+}
+
+static void UnmapArchive(AssetArchive* archive) {
+	free((void*)archive->data);
+}
+#else
+static bool MapArchive(const char* path, AssetArchive* archive) {
+	int file = open(path, O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+
+	struct stat status;
+	void* data = fstat(file, &status) == 0 && status.st_size > 0 ? mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+	// the mapping stays valid without the descriptor
+	close(file);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	archive->data = (const unsigned char*)data;
+	archive->size = (size_t)status.st_size;
+	archive->isMapped = true;
+	return true;
+}
+
+static void UnmapArchive(AssetArchive* archive) {
+	munmap((void*)archive->data, archive->size);
+}
+#endif
+
+// checks the header and that the index and every asset lie inside the archive
+static bool IsValidArchive(const AssetArchive& archive) {
+	if (archive.size < sizeof(AssetArchiveHeader)) {
+		return false;
+	}
+
+	const AssetArchiveHeader* header = (const AssetArchiveHeader*)archive.data;
+	if (memcmp(header->magic, ASSET_ARCHIVE_MAGIC, sizeof(header->magic)) != 0 || header->version != ASSET_ARCHIVE_VERSION ||
+		header->entryCount > (archive.size - sizeof(AssetArchiveHeader)) / sizeof(AssetArchiveEntry)) {
+		return false;
+	}
+
+	const AssetArchiveEntry* entries = (const AssetArchiveEntry*)(archive.data + sizeof(AssetArchiveHeader));
+	for (Uint32 i = 0; i < header->entryCount; ++i) {
+		if (memchr(entries[i].name, '\0', ASSET_NAME_SIZE) == NULL || entries[i].offset > archive.size ||
+			entries[i].size > archive.size - entries[i].offset) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool OpenAssetArchive(const char* path, AssetArchive* archive) {
+	*archive = AssetArchive();
+	if (!MapArchive(path, archive)) {
+		*archive = AssetArchive();
+		return false;
+	}
+
+	if (!IsValidArchive(*archive)) {
+		CloseAssetArchive(archive);
+		return false;
+	}
+
+	const AssetArchiveHeader* header = (const AssetArchiveHeader*)archive->data;
+	archive->entries = (const AssetArchiveEntry*)(archive->data + sizeof(AssetArchiveHeader));
+	archive->entryCount = header->entryCount;
+	return true;
+}
+
+void CloseAssetArchive(AssetArchive* archive) {
+	if (archive->data != NULL) {
+		UnmapArchive(archive);
+	}
+	*archive = AssetArchive();
+}
+
+const AssetArchiveEntry* FindAsset(const AssetArchive& archive, const char* name) {
+	Uint32 first = 0;
+	Uint32 last = archive.entryCount;
+	while (first < last) {
+		Uint32 middle = first + (last - first) / 2;
+		int order = strcmp(archive.entries[middle].name, name);
+		if (order == 0) {
+			return &archive.entries[middle];
+		}
+		if (order < 0) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+	return NULL;
+}
+
+Uint64 HashAssetData(const void* data, size_t size) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	Uint64 hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
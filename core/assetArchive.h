@@ -0,0 +1,61 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include <stddef.h>
+
+#include <SDL.h>
+
+// Packed asset archive, written by tools/assetPacker.cpp
+//   header: magic "BPAK", version, entry count, reserved
+//   index:  entry count entries sorted by name
+//   data:   the assets, each one aligned to ASSET_DATA_ALIGNMENT bytes
+// All values are little endian, like every platform the game runs on, so the index is used in place.
+// The archive is opened once and memory-mapped (read into a single buffer where there is no mmap),
+// assets are handed out as pointers into it without copying.
+const char ASSET_ARCHIVE_MAGIC[4] = { 'B', 'P', 'A', 'K' };
+const Uint32 ASSET_ARCHIVE_VERSION = 1;
+const int ASSET_NAME_SIZE = 48;
+const Uint32 ASSET_DATA_ALIGNMENT = 16;
+
+struct AssetArchiveHeader {
+	char magic[4];
+	Uint32 version;
+	Uint32 entryCount;
+	Uint32 reserved;
+};
+
+struct AssetArchiveEntry {
+	char name[ASSET_NAME_SIZE]; // NUL-terminated
+	Uint32 offset; // from the start of the archive
+	Uint32 size;
+	Uint64 hash; // HashAssetData() of the asset
+};
+
+struct AssetArchive {
+	const unsigned char* data;
+	size_t size;
+	const AssetArchiveEntry* entries;
+	Uint32 entryCount;
+	bool isMapped; // false if data was read into memory
+#ifdef _WIN32
+	void* file;
+	void* mapping;
+#endif
+};
+
+// Returns false if the file can not be mapped or is not a valid archive
+bool OpenAssetArchive(const char* path, AssetArchive* archive);
+
+void CloseAssetArchive(AssetArchive* archive);
+
+// Binary search in the index, NULL if there is no such asset
+const AssetArchiveEntry* FindAsset(const AssetArchive& archive, const char* name);
+
+inline const unsigned char* GetAssetData(const AssetArchive& archive, const AssetArchiveEntry& entry) {
+	return archive.data + entry.offset;
+}
+
+// 64 bit FNV-1a
+Uint64 HashAssetData(const void* data, size_t size);
+
+#endif
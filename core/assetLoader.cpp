@@ -0,0 +1,203 @@
+#include "assetLoader.h"
+
+#include <stdio.h>
+
+// path of a loose asset file, next to the archive
+static std::string GetAssetFilePath(const AssetLoader* loader, const std::string& name) {
+	size_t separator = loader->archivePath.find_last_of("/\\");
+	std::string directory(separator == std::string::npos ? "" : loader->archivePath.substr(0, separator + 1));
+	return directory + name;
+}
+
+static bool ReadAssetFile(const std::string& path, std::vector<unsigned char>* data) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+	bool isRead = size > 0 && fseek(file, 0, SEEK_SET) == 0;
+	if (isRead) {
+		data->resize(size);
+		isRead = fread(data->data(), 1, size, file) == (size_t)size;
+	}
+	fclose(file);
+	return isRead;
+}
+
+// false without a baked font that has both sizes, the TTF fonts are used then
+static bool LoadBakedFonts(AssetLoader* loader) {
+	if (loader->bakedFontName.empty()) {
+		return false;
+	}
+
+	bool isLoaded = false;
+	if (loader->isFromArchive) {
+		const AssetArchiveEntry* entry = FindAsset(loader->archive, loader->bakedFontName.c_str());
+		isLoaded = entry && LoadBakedFont(GetAssetData(loader->archive, *entry), entry->size, &loader->bakedFont);
+	}
+	else if (ReadAssetFile(GetAssetFilePath(loader, loader->bakedFontName), &loader->bakedFontFile)) {
+		isLoaded = LoadBakedFont(loader->bakedFontFile.data(), loader->bakedFontFile.size(), &loader->bakedFont);
+	}
+
+	const BakedFace* face = isLoaded ? FindBakedFace(loader->bakedFont, loader->fontSize) : NULL;
+	const BakedFace* bigFace = isLoaded ? FindBakedFace(loader->bakedFont, loader->bigFontSize) : NULL;
+	loader->bakedAtlas = face && bigFace ? CreateBakedAtlasSurface(loader->bakedFont) : NULL;
+	if (loader->bakedAtlas == NULL) {
+		return false;
+	}
+
+	loader->font = UIFont{ NULL, &loader->bakedFont, face, &loader->fontFallback };
+	loader->bigFont = UIFont{ NULL, &loader->bakedFont, bigFace, &loader->bigFontFallback };
+	return true;
+}
+
+static TTF_Font* OpenFont(AssetLoader* loader, const std::string& name, int size) {
+	if (!loader->isFromArchive) {
+		return TTF_OpenFont(GetAssetFilePath(loader, name).c_str(), size);
+	}
+
+	const AssetArchiveEntry* entry = FindAsset(loader->archive, name.c_str());
+	if (entry == NULL) {
+		TTF_SetError("%s is not in %s", name.c_str(), loader->archivePath.c_str());
+		return NULL;
+	}
+	// no copy, SDL_ttf reads the font from the archive for as long as it is open
+	return TTF_OpenFontRW(SDL_RWFromConstMem(GetAssetData(loader->archive, *entry), entry->size), 1, size);
+}
+
+static TTF_Font* OpenFallbackFont(void* context, const char* name, int size) {
+	return OpenFont((AssetLoader*)context, name, size);
+}
+
+static int SDLCALL LoadAssets(void* data) {
+	AssetLoader* loader = (AssetLoader*)data;
+
+	loader->isFromArchive = OpenAssetArchive(loader->archivePath.c_str(), &loader->archive);
+	if (!LoadBakedFonts(loader)) {
+		loader->font.ttf = OpenFont(loader, loader->fontName, loader->fontSize);
+		loader->bigFont.ttf = loader->font.ttf ? OpenFont(loader, loader->bigFontName, loader->bigFontSize) : NULL;
+	}
+	if (loader->bigFont.ttf == NULL && loader->bigFont.baked == NULL) {
+		// SDL errors are per thread, keep it for the render thread
+		loader->error = TTF_GetError();
+		loader->finishedAt = SDL_GetPerformanceCounter();
+		SDL_MemoryBarrierRelease();
+		SDL_AtomicSet(&loader->state, ASSETS_FAILED);
+		return 1;
+	}
+
+	RenderGameLabelSurfaces(&loader->surfaces, loader->font, loader->bigFont, loader->playAgainText.c_str(), loader->unpauseText.c_str());
+
+	loader->finishedAt = SDL_GetPerformanceCounter();
+	// the results above have to be visible before the state is (SDL_AtomicSet alone is only an acquire barrier with gcc)
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&loader->state, ASSETS_READY);
+	return 0;
+}
+
+bool StartAssetLoader(AssetLoader* loader, const char* archivePath, const char* bakedFontName, const char* fontName, int fontSize, const char* bigFontName, int bigFontSize,
+	const char* playAgainText, const char* unpauseText) {
+	loader->archivePath = archivePath;
+	loader->bakedFontName = bakedFontName ? bakedFontName : "";
+	loader->fontName = fontName;
+	loader->fontSize = fontSize;
+	loader->bigFontName = bigFontName;
+	loader->bigFontSize = bigFontSize;
+	loader->playAgainText = playAgainText;
+	loader->unpauseText = unpauseText;
+
+	loader->archive = AssetArchive();
+	loader->isFromArchive = false;
+	loader->bakedFontFile.clear();
+	loader->bakedFont = BakedFont();
+	loader->bakedAtlas = NULL;
+	loader->font = UIFont{ NULL, NULL, NULL, NULL };
+	loader->bigFont = UIFont{ NULL, NULL, NULL, NULL };
+	loader->fontFallback = TTFFallback{ OpenFallbackFont, loader, loader->fontName.c_str(), fontSize, NULL, false };
+	loader->bigFontFallback = TTFFallback{ OpenFallbackFont, loader, loader->bigFontName.c_str(), bigFontSize, NULL, false };
+	loader->surfaces = GameLabelSurfaces{ NULL, NULL, NULL, NULL, NULL, NULL };
+	loader->error.clear();
+	loader->startedAt = SDL_GetPerformanceCounter();
+	loader->finishedAt = 0;
+	SDL_AtomicSet(&loader->state, ASSETS_LOADING);
+	loader->isFinished = false;
+
+	loader->thread = SDL_CreateThread(LoadAssets, "AssetLoader", loader);
+	if (loader->thread == NULL) {
+		LoadAssets(loader);
+		return false;
+	}
+	return true;
+}
+
+AssetLoadState PollAssetLoader(AssetLoader* loader, SDL_Renderer* renderer, GameLabels* labels) {
+	AssetLoadState state = (AssetLoadState)SDL_AtomicGet(&loader->state);
+	if (state == ASSETS_LOADING || loader->isFinished) {
+		return state;
+	}
+	SDL_MemoryBarrierAcquire();
+
+	// the thread is done loading, so this hardly waits
+	if (loader->thread != NULL) {
+		SDL_WaitThread(loader->thread, NULL);
+		loader->thread = NULL;
+	}
+
+	if (state == ASSETS_READY && loader->bakedAtlas != NULL) {
+		bool isCreated = CreateBakedFontTexture(renderer, &loader->bakedFont, loader->bakedAtlas);
+		SDL_FreeSurface(loader->bakedAtlas);
+		loader->bakedAtlas = NULL;
+		if (!isCreated) {
+			loader->error = SDL_GetError();
+			state = ASSETS_FAILED;
+			SDL_AtomicSet(&loader->state, state);
+		}
+	}
+	if (state == ASSETS_READY) {
+		CreateGameLabelsFromSurfaces(renderer, labels, &loader->surfaces);
+	}
+	loader->isFinished = true;
+	return state;
+}
+
+double GetAssetLoadMillis(const AssetLoader& loader) {
+	if (loader.finishedAt == 0) {
+		return 0.0;
+	}
+	return (loader.finishedAt - loader.startedAt) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void DestroyAssetLoader(AssetLoader* loader) {
+	if (loader->thread != NULL) {
+		SDL_WaitThread(loader->thread, NULL);
+		loader->thread = NULL;
+	}
+
+	// only left if the labels were never created
+	FreeGameLabelSurfaces(&loader->surfaces);
+	if (loader->bakedAtlas != NULL) {
+		SDL_FreeSurface(loader->bakedAtlas);
+		loader->bakedAtlas = NULL;
+	}
+	DestroyBakedFontTexture(&loader->bakedFont);
+	if (loader->font.ttf != NULL) {
+		TTF_CloseFont(loader->font.ttf);
+	}
+	if (loader->bigFont.ttf != NULL) {
+		TTF_CloseFont(loader->bigFont.ttf);
+	}
+	if (loader->fontFallback.font != NULL) {
+		TTF_CloseFont(loader->fontFallback.font);
+	}
+	if (loader->bigFontFallback.font != NULL) {
+		TTF_CloseFont(loader->bigFontFallback.font);
+	}
+	loader->font = UIFont{ NULL, NULL, NULL, NULL };
+	loader->bigFont = UIFont{ NULL, NULL, NULL, NULL };
+	loader->fontFallback = TTFFallback();
+	loader->bigFontFallback = TTFFallback();
+	loader->bakedFont = BakedFont();
+	std::vector<unsigned char>().swap(loader->bakedFontFile);
+	CloseAssetArchive(&loader->archive);
+}
@@ -0,0 +1,72 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "assetArchive.h"
+#include "bakedFont.h"
+#include "gameRenderer.h"
+
+enum AssetLoadState {
+	ASSETS_LOADING = 0,
+	ASSETS_READY,
+	ASSETS_FAILED
+};
+
+// Opens the fonts and renders the label surfaces on a background thread, so the window and the renderer
+// can be created (and placeholder frames drawn) meanwhile. SDL renderers are not thread safe, so the
+// surfaces are uploaded by PollAssetLoader() on the render thread once the thread finished.
+// SDL_ttf must not be used by any other thread until then.
+// Fonts are read in place from the asset archive, or from files in the directory of the archive without one.
+// If the baked font has both sizes, FreeType is not used and the TTF fonts are not opened unless a label has
+// characters that were not baked
+struct AssetLoader {
+	// request, set before the thread starts
+	std::string archivePath;
+	std::string bakedFontName;
+	std::string fontName;
+	int fontSize;
+	std::string bigFontName;
+	int bigFontSize;
+	std::string playAgainText;
+	std::string unpauseText;
+
+	// results, written by the thread until state leaves ASSETS_LOADING
+	AssetArchive archive; // stays open while the fonts are
+	bool isFromArchive;
+	std::vector<unsigned char> bakedFontFile; // the baked font is read from the archive in place, from this without one
+	BakedFont bakedFont;
+	SDL_Surface* bakedAtlas; // uploaded and freed by PollAssetLoader()
+	UIFont font;
+	UIFont bigFont;
+	TTFFallback fontFallback; // for the baked fonts
+	TTFFallback bigFontFallback;
+	GameLabelSurfaces surfaces;
+	std::string error;
+	Uint64 startedAt; // performance counter
+	Uint64 finishedAt;
+	SDL_atomic_t state;
+
+	SDL_Thread* thread; // NULL once joined
+	bool isFinished; // render thread only, set once the labels were created (or loading failed)
+};
+
+// Returns false if the thread could not be created, the assets are then loaded synchronously
+bool StartAssetLoader(AssetLoader* loader, const char* archivePath, const char* bakedFontName, const char* fontName, int fontSize, const char* bigFontName, int bigFontSize,
+	const char* playAgainText, const char* unpauseText);
+
+// Never blocks while the thread is still working. The first call after it finished creates the labels
+// and the baked font texture
+AssetLoadState PollAssetLoader(AssetLoader* loader, SDL_Renderer* renderer, GameLabels* labels);
+
+// Milliseconds the thread took, 0 while it is still loading
+double GetAssetLoadMillis(const AssetLoader& loader);
+
+// Waits for the thread and closes the fonts (destroying the baked font texture) and the archive, labels created by PollAssetLoader() are destroyed by the caller
+void DestroyAssetLoader(AssetLoader* loader);
+
+#endif
@@ -0,0 +1,93 @@
+#include "autopilot.h"
+
+#include <string.h>
+
+// longest prediction, in frames
+const int MAX_PREDICTED_FRAMES = 2000;
+
+// Same result as checkBrickCollision() without walking the whole board: only the bricks of the grid cells
+// the ball touches are checked, in index order so the same brick wins. Returns -1 right away outside the
+// rows of bricks, where the ball spends most of its time
+static int FindBrickHit(const SDL_Rect* bricks, BrickState* brickStates, const SDL_Rect& ball, float yVel) {
+	if (ball.y >= BRICKS_BOTTOM || ball.y + ball.h <= BRICKS_TOP) {
+		return -1;
+	}
+
+	int firstRow = SDL_max(0, (ball.y - BRICKS_TOP) / BRICK_ROW_STRIDE);
+	int lastRow = SDL_min(LAYERS - 1, (ball.y + ball.h - 1 - BRICKS_TOP) / BRICK_ROW_STRIDE);
+	int firstColumn = SDL_max(0, (ball.x - BRICKS_LEFT_OFFSET) / BRICK_COLUMN_STRIDE);
+	int lastColumn = SDL_min(BRICKS_PER_LAYER - 1, (ball.x + ball.w - 1 - BRICKS_LEFT_OFFSET) / BRICK_COLUMN_STRIDE);
+	for (int row = firstRow; row <= lastRow; ++row) {
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			int i = row * BRICKS_PER_LAYER + column;
+			if (IsBrickHit(brickStates[i], bricks[i], ball, yVel)) {
+				brickStates[i] = DamageBrick(brickStates[i]);
+				return i;
+			}
+		}
+	}
+	return -1;
+}
+
+// frames until the ball comes down to the paddle, -1 if it does not within MAX_PREDICTED_FRAMES
+static int PredictLanding(const GameState& state, SDL_Rect ball, int xDirection, int yDirection, float timeDelta, int* landingX) {
+	BrickState brickStates[BRICKS_COUNT];
+	memcpy(brickStates, state.brickStates, sizeof(brickStates));
+
+	// the order of the checks follows StepGame()
+	for (int frame = 0; frame < MAX_PREDICTED_FRAMES; ++frame) {
+		float xVel = xDirection * state.ballSpeed * timeDelta;
+		float yVel = yDirection * state.ballSpeed * timeDelta;
+		if (ball.x + xVel < 0) {
+			xDirection *= -1;
+		}
+		if (ball.x + ball.w + xVel > GAME_WIDTH) {
+			xDirection *= -1;
+		}
+
+		// down at the paddle (or past it)
+		if (yDirection > 0 && (ball.y + ball.h > state.paddle.y || ball.y + ball.h + yVel > GAME_HEIGHT)) {
+			*landingX = ball.x + ball.w / 2;
+			return frame;
+		}
+
+		if (ball.y + yVel < CEILING_OFFSET) {
+			yDirection = 1;
+		}
+		if (FindBrickHit(state.bricks, brickStates, ball, yDirection * state.ballSpeed * timeDelta) != -1) {
+			yDirection *= -1;
+		}
+
+		ball.x += xDirection * state.ballSpeed * timeDelta;
+		ball.y += yDirection * state.ballSpeed * timeDelta;
+	}
+	return -1;
+}
+
+bool PredictBallLanding(const GameState& state, float timeDelta, int* landingX) {
+	return !state.isGameOver && PredictLanding(state, state.ball, state.xDirection, state.yDirection, timeDelta, landingX) != -1;
+}
+
+GameInput GetAutopilotInput(const GameState& state, float timeDelta) {
+	GameInput input{ 0.0f, false, state.isGameOver };
+
+	// follow the ball if the landing spot can not be predicted
+	int targetX = state.ball.x + state.ball.w / 2;
+	int frames = state.isGameOver ? -1 : PredictLanding(state, state.ball, state.xDirection, state.yDirection, timeDelta, &targetX);
+	// with more balls in play, go for the one coming down first
+	for (int i = 0; i < state.extraBallCount; ++i) {
+		int landingX = 0;
+		int extraFrames = PredictLanding(state, state.extraBalls[i], state.extraXDirections[i], state.extraYDirections[i], timeDelta, &landingX);
+		if (extraFrames != -1 && (frames == -1 || extraFrames < frames)) {
+			frames = extraFrames;
+			targetX = landingX;
+		}
+	}
+	// keep the paddle on screen
+	targetX = SDL_max(state.paddle.w / 2, SDL_min(targetX, GAME_WIDTH - state.paddle.w / 2));
+
+	float distance = targetX - (state.paddle.x + state.paddle.w / 2.0f);
+	float travel = distance / state.paddleSpeed;
+	input.paddleTravel = SDL_max(-timeDelta, SDL_min(travel, timeDelta));
+	return input;
+}
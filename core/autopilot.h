@@ -0,0 +1,18 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "game.h"
+
+// Paddle controller for attract mode and unattended soak runs.
+// It predicts where the ball comes down by following it frame by frame the way StepGame() moves it,
+// bouncing off the walls, the ceiling and the bricks it would hit, and moves the paddle under that spot.
+
+// x of the ball's center once it comes down to the paddle, false if it never does within a few seconds
+// (or the game is over). timeDelta is the frame time the game is stepped with
+bool PredictBallLanding(const GameState& state, float timeDelta, int* landingX);
+
+// Input moving the paddle towards the predicted landing spot of the ball coming down first, restarts the
+// game once it is over
+GameInput GetAutopilotInput(const GameState& state, float timeDelta);
+
+#endif
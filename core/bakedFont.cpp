@@ -0,0 +1,154 @@
+#include "bakedFont.h"
+
+#include <string.h>
+
+#include "gameRenderer.h"
+
+static_assert(sizeof(BakedFontHeader) == 16, "baked font header layout");
+static_assert(sizeof(BakedGlyph) == 10, "baked glyph layout");
+
+// characters that were not baked are drawn as '?'
+static const BakedGlyph& GetBakedGlyph(const BakedFace& face, char c) {
+	int index = (unsigned char)c - BAKED_FIRST_GLYPH;
+	if (index < 0 || index >= BAKED_GLYPH_COUNT) {
+		index = '?' - BAKED_FIRST_GLYPH;
+	}
+	return face.glyphs[index];
+}
+
+bool LoadBakedFont(const void* data, size_t size, BakedFont* font) {
+	*font = BakedFont();
+	if (size < sizeof(BakedFontHeader)) {
+		return false;
+	}
+
+	const BakedFontHeader* header = (const BakedFontHeader*)data;
+	size_t facesSize = header->faceCount * sizeof(BakedFace);
+	size_t atlasSize = (size_t)header->atlasWidth * header->atlasHeight;
+	if (memcmp(header->magic, BAKED_FONT_MAGIC, sizeof(header->magic)) != 0 || header->version != BAKED_FONT_VERSION ||
+		size < sizeof(BakedFontHeader) + facesSize + atlasSize) {
+		return false;
+	}
+
+	const BakedFace* faces = (const BakedFace*)(header + 1);
+	for (int i = 0; i < header->faceCount; ++i) {
+		for (int j = 0; j < BAKED_GLYPH_COUNT; ++j) {
+			const BakedGlyph& glyph = faces[i].glyphs[j];
+			if (glyph.x + glyph.w > header->atlasWidth || glyph.y + glyph.h > header->atlasHeight) {
+				return false;
+			}
+		}
+	}
+
+	font->header = header;
+	font->faces = faces;
+	font->atlas = (const unsigned char*)data + sizeof(BakedFontHeader) + facesSize;
+	return true;
+}
+
+const BakedFace* FindBakedFace(const BakedFont& font, int size) {
+	for (int i = 0; font.header && i < font.header->faceCount; ++i) {
+		if (font.faces[i].size == size) {
+			return &font.faces[i];
+		}
+	}
+	return NULL;
+}
+
+bool HasBakedGlyphs(const BakedFace& face, const char* text) {
+	for (; *text; ++text) {
+		int index = (unsigned char)*text - BAKED_FIRST_GLYPH;
+		// a glyph the font did not have was baked without an advance
+		if (index < 0 || index >= BAKED_GLYPH_COUNT || face.glyphs[index].advance == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int MeasureBakedText(const BakedFace& face, const char* text) {
+	int width = 0;
+	for (; *text; ++text) {
+		width += GetBakedGlyph(face, *text).advance;
+	}
+	return width;
+}
+
+SDL_Surface* CreateBakedAtlasSurface(const BakedFont& font) {
+	int width = font.header->atlasWidth;
+	int height = font.header->atlasHeight;
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL) {
+		return NULL;
+	}
+
+	for (int y = 0; y < height; ++y) {
+		Uint32* pixel = (Uint32*)((Uint8*)surface->pixels + y * surface->pitch);
+		const unsigned char* coverage = font.atlas + y * width;
+		for (int x = 0; x < width; ++x) {
+			pixel[x] = ((Uint32)coverage[x] << 24) | 0x00FFFFFF;
+		}
+	}
+	return surface;
+}
+
+SDL_Surface* RenderBakedText(const BakedFont& font, const BakedFace& face, const char* text) {
+	int width = MeasureBakedText(face, text);
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width > 0 ? width : 1, face.lineHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL) {
+		return NULL;
+	}
+	SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
+
+	int penX = 0;
+	for (; *text; ++text) {
+		const BakedGlyph& glyph = GetBakedGlyph(face, *text);
+		for (int row = 0; row < glyph.h; ++row) {
+			int y = glyph.offsetY + row;
+			if (y < 0 || y >= surface->h) {
+				continue;
+			}
+			Uint32* pixel = (Uint32*)((Uint8*)surface->pixels + y * surface->pitch);
+			const unsigned char* coverage = font.atlas + (glyph.y + row) * font.header->atlasWidth + glyph.x;
+			for (int column = 0; column < glyph.w; ++column) {
+				int x = penX + glyph.offsetX + column;
+				// glyphs may overlap, keep the higher coverage
+				if (x >= 0 && x < surface->w && coverage[column] > (pixel[x] >> 24)) {
+					pixel[x] = ((Uint32)coverage[column] << 24) | 0x00FFFFFF;
+				}
+			}
+		}
+		penX += glyph.advance;
+	}
+	return surface;
+}
+
+bool CreateBakedFontTexture(SDL_Renderer* renderer, BakedFont* font, SDL_Surface* atlas) {
+	font->texture = SDL_CreateTextureFromSurface(renderer, atlas);
+	if (font->texture == NULL) {
+		return false;
+	}
+	++gRenderStats.textureCreations;
+	SDL_SetTextureBlendMode(font->texture, SDL_BLENDMODE_BLEND);
+	return true;
+}
+
+void DestroyBakedFontTexture(BakedFont* font) {
+	if (font->texture != NULL) {
+		SDL_DestroyTexture(font->texture);
+		font->texture = NULL;
+	}
+}
+
+void DrawBakedText(SDL_Renderer* renderer, const BakedFont& font, const BakedFace& face, const char* text, int x, int y) {
+	for (; *text; ++text) {
+		const BakedGlyph& glyph = GetBakedGlyph(face, *text);
+		if (glyph.w > 0 && glyph.h > 0) {
+			SDL_Rect source{ glyph.x, glyph.y, glyph.w, glyph.h };
+			SDL_Rect destination{ x + glyph.offsetX, y + glyph.offsetY, glyph.w, glyph.h };
+			SDL_RenderCopy(renderer, font.texture, &source, &destination);
+			++gRenderStats.drawCalls;
+		}
+		x += glyph.advance;
+	}
+}
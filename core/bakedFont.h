@@ -0,0 +1,78 @@
+#ifndef BAKED_FONT_H
+#define BAKED_FONT_H
+
+#include <stddef.h>
+
+#include <SDL.h>
+
+// Glyphs rasterized offline by tools/fontBaker.cpp, so text can be drawn without FreeType at runtime
+//   header: magic "BFNT", version, face count, atlas size
+//   faces:  metrics of the printable ASCII glyphs for every baked size
+//   atlas:  8 bit coverage of all glyphs, atlasWidth * atlasHeight bytes
+// Like the asset archive the blob is little endian and used in place.
+const char BAKED_FONT_MAGIC[4] = { 'B', 'F', 'N', 'T' };
+const Uint16 BAKED_FONT_VERSION = 1;
+const int BAKED_FIRST_GLYPH = 32;
+const int BAKED_GLYPH_COUNT = 95; // ' ' to '~'
+
+struct BakedFontHeader {
+	char magic[4];
+	Uint16 version;
+	Uint16 faceCount;
+	Uint16 atlasWidth;
+	Uint16 atlasHeight;
+	Uint32 reserved;
+};
+
+struct BakedGlyph {
+	Uint16 x; // in the atlas
+	Uint16 y;
+	Uint8 w;
+	Uint8 h;
+	Sint8 offsetX; // from the pen position
+	Sint8 offsetY; // from the top of the line
+	Uint8 advance;
+	Uint8 reserved;
+};
+
+struct BakedFace {
+	Uint16 size; // point size it was baked with
+	Uint16 lineHeight;
+	Uint16 ascent;
+	Uint16 reserved;
+	BakedGlyph glyphs[BAKED_GLYPH_COUNT];
+};
+
+struct BakedFont {
+	const BakedFontHeader* header;
+	const BakedFace* faces;
+	const unsigned char* atlas;
+	SDL_Texture* texture; // created from the atlas on the render thread, NULL until then
+};
+
+// Points font into data (which has to outlive it), returns false if data is not a valid blob
+bool LoadBakedFont(const void* data, size_t size, BakedFont* font);
+
+// NULL if the size was not baked
+const BakedFace* FindBakedFace(const BakedFont& font, int size);
+
+// True if every character of text was baked and the font had a glyph for it
+bool HasBakedGlyphs(const BakedFace& face, const char* text);
+
+int MeasureBakedText(const BakedFace& face, const char* text);
+
+// White text with the coverage as alpha, can be called from any thread
+SDL_Surface* CreateBakedAtlasSurface(const BakedFont& font);
+
+// Text in a surface of its own like TTF_RenderText_*, can be called from any thread
+SDL_Surface* RenderBakedText(const BakedFont& font, const BakedFace& face, const char* text);
+
+// Uploads the atlas surface, render thread only
+bool CreateBakedFontTexture(SDL_Renderer* renderer, BakedFont* font, SDL_Surface* atlas);
+
+void DestroyBakedFontTexture(BakedFont* font);
+
+// Draws text with its top left corner at x, y straight from the atlas texture, one copy per glyph
+void DrawBakedText(SDL_Renderer* renderer, const BakedFont& font, const BakedFace& face, const char* text, int x, int y);
+
+#endif
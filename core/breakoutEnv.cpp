@@ -0,0 +1,143 @@
+#include "breakoutEnv.h"
+
+#include <new>
+#include <thread>
+
+#include "game.h"
+#include "observationRenderer.h"
+
+static_assert(BREAKOUT_ENV_OBSERVATION_SIZE == BREAKOUT_ENV_BRICKS + BRICKS_COUNT, "one observation value per brick");
+
+const float ENV_STEP_SECONDS = TARGET_MILLIS_PER_FRAME / (float)1000;
+
+struct BreakoutEnv {
+	int steps; // in the current episode
+	bool isDone; // the next step starts a new episode
+};
+
+struct BreakoutEnvBatch {
+	int envCount;
+	int frameSkip;
+	int maxEpisodeSteps;
+	GameState* games; // kept apart from envs, so they can be rendered as one array
+	BreakoutEnv* envs;
+	ObservationWorkers* renderWorkers; // one per hardware thread, started with the batch
+};
+
+// splitmix32 finalizer, gives neighbouring games unrelated seeds. Never 0, which would make the game use rand()
+static Uint32 MixSeed(Uint32 seed, Uint32 index) {
+	Uint32 x = seed + index * 0x9E3779B9u;
+	x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+	x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+	x ^= x >> 16;
+	return x != 0 ? x : 1;
+}
+
+// Power-ups are off: extra balls, falling power-ups, laser shots and their effects are not in the observation
+static void InitEnvGame(GameState* game, Uint32 seed) {
+	InitSeededGame(game, seed);
+	game->arePowerUpsEnabled = false;
+}
+
+static void WriteObservation(const GameState& game, float* observation) {
+	observation[BREAKOUT_ENV_BALL_X] = game.ball.x / (float)GAME_WIDTH;
+	observation[BREAKOUT_ENV_BALL_Y] = game.ball.y / (float)GAME_HEIGHT;
+	observation[BREAKOUT_ENV_BALL_DIRECTION_X] = (float)game.xDirection;
+	observation[BREAKOUT_ENV_BALL_DIRECTION_Y] = (float)game.yDirection;
+	observation[BREAKOUT_ENV_PADDLE_X] = game.paddle.x / (float)GAME_WIDTH;
+	observation[BREAKOUT_ENV_LIVES] = game.lives / (float)STARTING_LIVES;
+
+	float* bricks = observation + BREAKOUT_ENV_BRICKS;
+	for (int i = 0; i < BRICKS_COUNT; ++i) {
+		bricks[i] = GetBrickHitPoints(game.brickStates[i]) != 0 ? 1.0f : 0.0f;
+	}
+}
+
+BreakoutEnvBatch* BreakoutEnvCreate(int envCount, int frameSkip, int maxEpisodeSteps) {
+	if (envCount <= 0 || frameSkip <= 0) {
+		return NULL;
+	}
+
+	BreakoutEnvBatch* batch = new (std::nothrow) BreakoutEnvBatch();
+	GameState* games = new (std::nothrow) GameState[envCount];
+	BreakoutEnv* envs = new (std::nothrow) BreakoutEnv[envCount];
+	int renderThreads = SDL_min((int)SDL_max(1u, std::thread::hardware_concurrency()), envCount);
+	ObservationWorkers* renderWorkers = CreateObservationWorkers(renderThreads);
+	if (batch == NULL || games == NULL || envs == NULL || renderWorkers == NULL) {
+		delete batch;
+		delete[] games;
+		delete[] envs;
+		DestroyObservationWorkers(renderWorkers);
+		return NULL;
+	}
+
+	batch->envCount = envCount;
+	batch->frameSkip = frameSkip;
+	batch->maxEpisodeSteps = maxEpisodeSteps > 0 ? maxEpisodeSteps : 0;
+	batch->games = games;
+	batch->envs = envs;
+	batch->renderWorkers = renderWorkers;
+	for (int i = 0; i < envCount; ++i) {
+		InitEnvGame(&games[i], MixSeed(0, i));
+		envs[i].steps = 0;
+		envs[i].isDone = false;
+	}
+	return batch;
+}
+
+void BreakoutEnvDestroy(BreakoutEnvBatch* batch) {
+	if (batch != NULL) {
+		delete[] batch->games;
+		delete[] batch->envs;
+		DestroyObservationWorkers(batch->renderWorkers);
+		delete batch;
+	}
+}
+
+int BreakoutEnvCount(const BreakoutEnvBatch* batch) {
+	return batch->envCount;
+}
+
+void BreakoutEnvReset(BreakoutEnvBatch* batch, uint32_t seed, float* observations) {
+	for (int i = 0; i < batch->envCount; ++i) {
+		BreakoutEnv& env = batch->envs[i];
+		InitEnvGame(&batch->games[i], MixSeed(seed, i));
+		env.steps = 0;
+		env.isDone = false;
+		WriteObservation(batch->games[i], observations + i * BREAKOUT_ENV_OBSERVATION_SIZE);
+	}
+}
+
+void BreakoutEnvStep(BreakoutEnvBatch* batch, const int32_t* actions, float* observations, float* rewards, uint8_t* dones) {
+	for (int i = 0; i < batch->envCount; ++i) {
+		BreakoutEnv& env = batch->envs[i];
+		GameState& game = batch->games[i];
+		if (env.isDone) {
+			// the game's random state carries on into the next episode
+			InitEnvGame(&game, game.randomState);
+			env.steps = 0;
+			env.isDone = false;
+		}
+
+		int action = actions[i] < BREAKOUT_ENV_LEFT ? BREAKOUT_ENV_LEFT : (actions[i] > BREAKOUT_ENV_RIGHT ? BREAKOUT_ENV_RIGHT : actions[i]);
+		GameInput input{ action * ENV_STEP_SECONDS, false, false };
+		int scoreBefore = game.score;
+		for (int frame = 0; frame < batch->frameSkip && !game.isGameOver; ++frame) {
+			StepGame(&game, input, ENV_STEP_SECONDS);
+		}
+
+		++env.steps;
+		env.isDone = game.isGameOver || (batch->maxEpisodeSteps > 0 && env.steps >= batch->maxEpisodeSteps);
+		rewards[i] = (float)(game.score - scoreBefore);
+		dones[i] = env.isDone ? 1 : 0;
+		WriteObservation(game, observations + i * BREAKOUT_ENV_OBSERVATION_SIZE);
+	}
+}
+
+int BreakoutEnvRender(const BreakoutEnvBatch* batch, int width, int height, uint8_t* pixels, int threadCount) {
+	if (!IsValidObservationSize(width, height)) {
+		return 0;
+	}
+	RenderObservations(batch->renderWorkers, batch->games, batch->envCount, width, height, pixels, threadCount);
+	return 1;
+}
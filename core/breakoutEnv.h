@@ -0,0 +1,75 @@
+#ifndef BREAKOUT_ENV_H
+#define BREAKOUT_ENV_H
+
+// Reinforcement learning environment over the gameplay core, built as the breakout_env shared library.
+// Plain C so it can be loaded in process (e.g. with Python's ctypes or cffi).
+//
+// A batch steps envCount games at once. Every game steps at the target frame rate and is seeded on its own,
+// so a batch replays the same way for the same seed and actions no matter how many games it holds.
+// The games are played without power-ups, so the observation below holds everything that moves.
+// Observations, rewards and done flags are written into buffers owned by the caller; stepping neither
+// allocates nor copies anything else.
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BREAKOUT_ENV_BUILD)
+#define BREAKOUT_ENV_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define BREAKOUT_ENV_API __declspec(dllimport)
+#else
+#define BREAKOUT_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Observation of a single game, BREAKOUT_ENV_OBSERVATION_SIZE floats
+enum {
+	BREAKOUT_ENV_BALL_X = 0, // ball and paddle positions are divided by the game size, so they lie in [0, 1]
+	BREAKOUT_ENV_BALL_Y,
+	BREAKOUT_ENV_BALL_DIRECTION_X, // -1 or 1
+	BREAKOUT_ENV_BALL_DIRECTION_Y,
+	BREAKOUT_ENV_PADDLE_X,
+	BREAKOUT_ENV_LIVES, // lives left divided by the starting lives
+	BREAKOUT_ENV_BRICKS, // 1 for every brick still standing (indestructible ones too), layer by layer from the top
+	BREAKOUT_ENV_OBSERVATION_SIZE = BREAKOUT_ENV_BRICKS + 8 * 13
+};
+
+// Actions move the paddle for a whole step
+enum {
+	BREAKOUT_ENV_LEFT = -1,
+	BREAKOUT_ENV_STAY = 0,
+	BREAKOUT_ENV_RIGHT = 1
+};
+
+typedef struct BreakoutEnvBatch BreakoutEnvBatch;
+
+// frameSkip frames are simulated with the same action per step. An episode ends when the game is over
+// or after maxEpisodeSteps steps (0 for no limit). NULL if envCount or frameSkip is not positive
+BREAKOUT_ENV_API BreakoutEnvBatch* BreakoutEnvCreate(int envCount, int frameSkip, int maxEpisodeSteps);
+
+BREAKOUT_ENV_API void BreakoutEnvDestroy(BreakoutEnvBatch* batch);
+
+BREAKOUT_ENV_API int BreakoutEnvCount(const BreakoutEnvBatch* batch);
+
+// Starts a new episode in every game, each one seeded from seed and its index.
+// observations holds envCount * BREAKOUT_ENV_OBSERVATION_SIZE floats
+BREAKOUT_ENV_API void BreakoutEnvReset(BreakoutEnvBatch* batch, uint32_t seed, float* observations);
+
+// actions, rewards and dones hold envCount values. The reward is the score gained during the step.
+// A game whose episode ended (done set to 1) still reports its final observation and starts its next
+// episode on the following step, from its own random numbers
+BREAKOUT_ENV_API void BreakoutEnvStep(BreakoutEnvBatch* batch, const int32_t* actions, float* observations, float* rewards, uint8_t* dones);
+
+// Pixel observations: draws every game as a width x height grayscale image (e.g. 84 x 84), one byte per pixel
+// with rows from the top, into pixels (envCount * width * height bytes). The games are split between
+// threadCount threads, 1 renders on the calling thread. The threads are started by BreakoutEnvCreate(), one per
+// hardware thread, so threadCount is capped at that. Only the first call at a size allocates (a scratch image
+// per thread). Returns 0 if the size is not in 1 to 960 x 1 to 544
+BREAKOUT_ENV_API int BreakoutEnvRender(const BreakoutEnvBatch* batch, int width, int height, uint8_t* pixels, int threadCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+#include "compactGame.h"
+
+// CompareCompactGames() lists every field, update it when the layout changes
+static_assert(sizeof(CompactGame) == 56, "compact game layout");
+// a single damaged bit per brick
+static_assert(DURABLE_BRICK_HIT_POINTS == 2, "durable bricks take two hits");
+
+const int PADDLE_Y = (GAME_HEIGHT - PADDLE_HEIGHT) - 20;
+
+// where initBrickPositions() puts the brick
+static SDL_Rect GetBrickRect(int index) {
+	int row = index / BRICKS_PER_LAYER;
+	int column = index % BRICKS_PER_LAYER;
+	return SDL_Rect{ column * BRICK_COLUMN_STRIDE + BRICKS_LEFT_OFFSET, row * BRICK_ROW_STRIDE + BRICKS_TOP, BRICK_WIDTH, BRICK_HEIGHT };
+}
+
+static void SetBit(Uint64* bits, int index, bool isSet) {
+	Uint64 mask = (Uint64)1 << (index & 63);
+	bits[index >> 6] = isSet ? bits[index >> 6] | mask : bits[index >> 6] & ~mask;
+}
+
+static void SetCompactBrickState(CompactGame* game, int index, BrickState brick) {
+	bool isDestructible = GetBrickType(brick) != BrickType::INDESTRUCTIBLE;
+	int hitPoints = GetBrickHitPoints(brick);
+	SetBit(game->bricks, index, isDestructible && hitPoints != 0);
+	SetBit(game->damagedBricks, index, GetBrickType(brick) == BrickType::DURABLE && hitPoints != 0 && hitPoints < DURABLE_BRICK_HIT_POINTS);
+}
+
+BrickState GetCompactBrickState(const CompactGame& game, int index) {
+	BrickState brick = GetLevelBoard(game.level).brickStates[index];
+	if (GetBrickType(brick) == BrickType::INDESTRUCTIBLE) {
+		return brick;
+	}
+	if (!IsBrickStanding(game, index)) {
+		return MakeBrickState(GetBrickType(brick), 0, GetBrickLayer(brick));
+	}
+	bool isDamaged = (game.damagedBricks[index >> 6] >> (index & 63)) & 1;
+	return isDamaged ? DamageBrick(brick) : brick;
+}
+
+static void PackBricks(const BrickState* brickStates, CompactGame* game) {
+	for (int i = 0; i < BRICKS_COUNT; ++i) {
+		SetCompactBrickState(game, i, brickStates[i]);
+	}
+}
+
+// checkBrickCollision() through the grid cells the ball touches, see FindBrickHit() in autopilot.cpp
+static int FindBrickHit(CompactGame* game, const SDL_Rect& ball, float yVel) {
+	if (ball.y >= BRICKS_BOTTOM || ball.y + ball.h <= BRICKS_TOP) {
+		return -1;
+	}
+
+	int firstRow = SDL_max(0, (ball.y - BRICKS_TOP) / BRICK_ROW_STRIDE);
+	int lastRow = SDL_min(LAYERS - 1, (ball.y + ball.h - 1 - BRICKS_TOP) / BRICK_ROW_STRIDE);
+	int firstColumn = SDL_max(0, (ball.x - BRICKS_LEFT_OFFSET) / BRICK_COLUMN_STRIDE);
+	int lastColumn = SDL_min(BRICKS_PER_LAYER - 1, (ball.x + ball.w - 1 - BRICKS_LEFT_OFFSET) / BRICK_COLUMN_STRIDE);
+	for (int row = firstRow; row <= lastRow; ++row) {
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			int i = row * BRICKS_PER_LAYER + column;
+			BrickState brick = GetCompactBrickState(*game, i);
+			if (IsBrickHit(brick, GetBrickRect(i), ball, yVel)) {
+				SetCompactBrickState(game, i, DamageBrick(brick));
+				return i;
+			}
+		}
+	}
+	return -1;
+}
+
+void PackGame(const GameState& state, CompactGame* game) {
+	*game = CompactGame();
+	PackBricks(state.brickStates, game);
+	game->randomState = state.randomState;
+	game->paddleRemainder = state.paddleRemainder;
+	game->paddleX = state.paddle.x;
+	game->ballX = (Sint16)state.ball.x;
+	game->ballY = (Sint16)state.ball.y;
+	game->score = (Uint16)state.score;
+	game->xDirection = (Sint8)state.xDirection;
+	game->yDirection = (Sint8)state.yDirection;
+	game->lives = (Sint8)state.lives;
+	game->level = (Uint8)state.level;
+	game->isGameOver = state.isGameOver;
+}
+
+void UnpackGame(const CompactGame& game, GameState* state) {
+	state->score = game.score;
+	state->lives = game.lives;
+	state->isGameOver = game.isGameOver;
+	state->isGamePaused = false;
+
+	state->paddle = { game.paddleX, PADDLE_Y, PADDLE_WIDTH, PADDLE_HEIGHT };
+	state->paddleSpeed = PADDLE_SPEED;
+	state->paddleRemainder = game.paddleRemainder;
+
+	state->ball = { game.ballX, game.ballY, BALL_WIDTH, BALL_HEIGHT };
+	state->ballSpeed = GetLevelBallSpeed(game.level);
+	state->xDirection = game.xDirection;
+	state->yDirection = game.yDirection;
+
+	initBrickPositions(state->bricks, LAYERS, BRICKS_PER_LAYER, BRICK_WIDTH, BRICK_HEIGHT, BRICK_HORIZ_PADDING, BRICK_VERT_PADDING);
+	state->level = game.level;
+	state->bricksLeft = 0;
+	for (int i = 0; i < BRICKS_COUNT; ++i) {
+		state->brickStates[i] = GetCompactBrickState(game, i);
+		state->bricksLeft += IsBrickStanding(game, i) ? 1 : 0;
+	}
+	state->randomState = game.randomState;
+
+	state->arePowerUpsEnabled = false;
+	state->extraBallCount = 0;
+	ClearEntities(&state->entities);
+	ClearEffectWheel(&state->effects);
+}
+
+int StepCompactGame(CompactGame* game, float paddleTravel, float timeDelta) {
+	// the checks and the float to int conversions follow StepGame() exactly
+	SDL_Rect ball{ game->ballX, game->ballY, BALL_WIDTH, BALL_HEIGHT };
+	int xDirection = game->xDirection;
+	int yDirection = game->yDirection;
+	int ballSpeed = GetLevelBallSpeed(game->level);
+	float xVel = xDirection * ballSpeed * timeDelta;
+	float yVel = yDirection * ballSpeed * timeDelta;
+
+	if (ball.x + xVel < 0) {
+		xDirection *= -1;
+	}
+	if (ball.x + ball.w + xVel > GAME_WIDTH) {
+		xDirection *= -1;
+	}
+
+	// lose live condition
+	if (ball.y + ball.h + yVel > GAME_HEIGHT) {
+		if (game->lives - 1 >= 0) {
+			--game->lives;
+		}
+
+		if (game->lives > 0) {
+			SetSeededBallDirection(&game->randomState, &xDirection, &yDirection);
+			ResetBallPosition(&ball);
+		}
+		else {
+			game->isGameOver = true;
+		}
+	}
+
+	if (ball.y + yVel < CEILING_OFFSET) {
+		yDirection = 1;
+	}
+
+	SDL_Rect paddle{ game->paddleX, PADDLE_Y, PADDLE_WIDTH, PADDLE_HEIGHT };
+	if (canRectanglesOverlap(ball, paddle)) {
+		yDirection *= -1;
+	}
+
+	int brickIndex = FindBrickHit(game, ball, yDirection * ballSpeed * timeDelta);
+	if (brickIndex != -1) {
+		yDirection *= -1;
+		BrickState brick = GetCompactBrickState(*game, brickIndex);
+		if (GetBrickType(brick) != BrickType::INDESTRUCTIBLE) {
+			game->score += getScoresTable().at((ColorLabel)GetBrickLayer(brick));
+		}
+
+		// StartLevel()
+		if (AreAllBricksDestroyed(*game)) {
+			++game->level;
+			PackBricks(GetLevelBoard(game->level).brickStates, game);
+			ballSpeed = GetLevelBallSpeed(game->level);
+			ResetBallPosition(&ball);
+			SetSeededBallDirection(&game->randomState, &xDirection, &yDirection);
+			game->paddleX = (GAME_WIDTH - PADDLE_WIDTH) / 2;
+			game->paddleRemainder = 0.0f;
+		}
+	}
+
+	if (!game->isGameOver) {
+		game->paddleRemainder += PADDLE_SPEED * paddleTravel;
+		int paddleStep = (int)game->paddleRemainder;
+		game->paddleX += paddleStep;
+		game->paddleRemainder -= paddleStep;
+	}
+	else {
+		game->paddleRemainder = 0.0f;
+	}
+
+	ball.x += xDirection * ballSpeed * timeDelta;
+	ball.y += yDirection * ballSpeed * timeDelta;
+	game->ballX = (Sint16)ball.x;
+	game->ballY = (Sint16)ball.y;
+	game->xDirection = (Sint8)xDirection;
+	game->yDirection = (Sint8)yDirection;
+	return brickIndex;
+}
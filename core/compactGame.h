@@ -0,0 +1,66 @@
+#ifndef COMPACT_GAME_H
+#define COMPACT_GAME_H
+
+#include "game.h"
+
+// GameState packed into 56 bytes for searches that clone and step millions of games: the bricks are bitsets
+// (their rectangles follow from the index and their types from the level's board, see GetLevelBoard()),
+// the ball speed follows from the level and the other sizes and speeds are the defaults InitGame() sets.
+// It is plain data, cloning is a copy. Pause and restart are left out, a finished game stays over, and so are
+// power-ups: only games with arePowerUpsEnabled off can be packed. New fields go in CompareCompactGames() as well.
+struct CompactGame {
+	Uint64 bricks[2]; // bit i set while brick i stands, indestructible bricks are left out
+	Uint64 damagedBricks[2]; // bit i set once durable brick i took a hit
+	Uint32 randomState; // see GameState::randomState
+	float paddleRemainder;
+	Sint32 paddleX; // the game does not keep the paddle on screen
+	Sint16 ballX;
+	Sint16 ballY;
+	Uint16 score;
+	Sint8 xDirection;
+	Sint8 yDirection;
+	Sint8 lives;
+	Uint8 level;
+	bool isGameOver;
+};
+
+void PackGame(const GameState& state, CompactGame* game);
+
+void UnpackGame(const CompactGame& game, GameState* state);
+
+// Orders by every field, negative if a comes first, 0 for the same game. For sorting and deduplicating searches
+inline int CompareCompactGames(const CompactGame& a, const CompactGame& b) {
+	if (a.level != b.level) return a.level < b.level ? -1 : 1;
+	if (a.score != b.score) return a.score < b.score ? -1 : 1;
+	if (a.lives != b.lives) return a.lives < b.lives ? -1 : 1;
+	if (a.isGameOver != b.isGameOver) return a.isGameOver < b.isGameOver ? -1 : 1;
+	if (a.bricks[0] != b.bricks[0]) return a.bricks[0] < b.bricks[0] ? -1 : 1;
+	if (a.bricks[1] != b.bricks[1]) return a.bricks[1] < b.bricks[1] ? -1 : 1;
+	if (a.damagedBricks[0] != b.damagedBricks[0]) return a.damagedBricks[0] < b.damagedBricks[0] ? -1 : 1;
+	if (a.damagedBricks[1] != b.damagedBricks[1]) return a.damagedBricks[1] < b.damagedBricks[1] ? -1 : 1;
+	if (a.paddleX != b.paddleX) return a.paddleX < b.paddleX ? -1 : 1;
+	if (a.paddleRemainder != b.paddleRemainder) return a.paddleRemainder < b.paddleRemainder ? -1 : 1;
+	if (a.ballX != b.ballX) return a.ballX < b.ballX ? -1 : 1;
+	if (a.ballY != b.ballY) return a.ballY < b.ballY ? -1 : 1;
+	if (a.xDirection != b.xDirection) return a.xDirection < b.xDirection ? -1 : 1;
+	if (a.yDirection != b.yDirection) return a.yDirection < b.yDirection ? -1 : 1;
+	if (a.randomState != b.randomState) return a.randomState < b.randomState ? -1 : 1;
+	return 0;
+}
+
+// for the bricks that can be destroyed
+inline bool IsBrickStanding(const CompactGame& game, int index) {
+	return (game.bricks[index >> 6] >> (index & 63)) & 1;
+}
+
+// level cleared, StepCompactGame() moves on to the next board in the same step so this only holds for packed games
+inline bool AreAllBricksDestroyed(const CompactGame& game) {
+	return game.bricks[0] == 0 && game.bricks[1] == 0;
+}
+
+BrickState GetCompactBrickState(const CompactGame& game, int index);
+
+// Same as StepGame() with GameInput{ paddleTravel, false, false }, returns the index of the brick hit or -1
+int StepCompactGame(CompactGame* game, float paddleTravel, float timeDelta);
+
+#endif
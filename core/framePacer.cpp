@@ -0,0 +1,132 @@
+#include "framePacer.h"
+
+#include <string.h>
+
+#include "game.h"
+
+static const char* const PRESENT_MODE_NAMES[] = { "auto", "vsync", "paced", "uncapped" };
+
+const char* GetPresentModeName(PresentMode mode) {
+	return PRESENT_MODE_NAMES[(int)mode];
+}
+
+bool ParsePresentMode(const char* name, PresentMode* mode) {
+	for (int i = 0; i <= (int)PresentMode::UNCAPPED; ++i) {
+		if (strcmp(name, PRESENT_MODE_NAMES[i]) == 0) {
+			*mode = (PresentMode)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+Uint32 GetPresentRendererFlags(PresentMode requested) {
+	return requested == PresentMode::AUTO || requested == PresentMode::VSYNC ? SDL_RENDERER_PRESENTVSYNC : 0;
+}
+
+static double ToMillis(Uint64 ticks) {
+	return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void InitFramePacer(FramePacer* pacer, SDL_Renderer* renderer, PresentMode requested) {
+	*pacer = FramePacer();
+	pacer->mode = requested;
+	if (requested == PresentMode::AUTO || requested == PresentMode::VSYNC) {
+		SDL_RendererInfo info;
+		bool hasVsync = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+		pacer->mode = hasVsync ? PresentMode::VSYNC : PresentMode::PACED;
+		if (!hasVsync && requested == PresentMode::VSYNC) {
+			SDL_Log("the renderer has no vsync, pacing frames by sleeping");
+		}
+	}
+
+	pacer->refreshMillis = pacer->mode == PresentMode::UNCAPPED ? 0.0 : TARGET_MILLIS_PER_FRAME;
+	if (pacer->mode == PresentMode::VSYNC) {
+		// what the main display says until presents are measured
+		SDL_DisplayMode displayMode;
+		if (SDL_GetCurrentDisplayMode(0, &displayMode) == 0 && displayMode.refresh_rate > 0) {
+			pacer->refreshMillis = 1000.0 / displayMode.refresh_rate;
+		}
+	}
+	pacer->steps = 1;
+	ResetFramePacerReport(pacer);
+}
+
+void BeginPacedFrame(FramePacer* pacer) {
+	pacer->frameStart = SDL_GetPerformanceCounter();
+}
+
+void PresentPacedFrame(FramePacer* pacer, SDL_Renderer* renderer) {
+	Uint64 presentStart = SDL_GetPerformanceCounter();
+	SDL_RenderPresent(renderer);
+	Uint64 presentEnd = SDL_GetPerformanceCounter();
+
+	double presentMillis = ToMillis(presentEnd - presentStart);
+	double latencyMillis = ToMillis(presentEnd - pacer->frameStart);
+	pacer->lastPresentMillis = presentMillis;
+	++pacer->frames;
+	pacer->presentMillis += presentMillis;
+	pacer->maxPresentMillis = SDL_max(pacer->maxPresentMillis, presentMillis);
+	pacer->latencyMillis += latencyMillis;
+	pacer->maxLatencyMillis = SDL_max(pacer->maxLatencyMillis, latencyMillis);
+
+	if (pacer->mode == PresentMode::VSYNC && pacer->previousPresent != 0) {
+		double interval = ToMillis(presentEnd - pacer->previousPresent);
+		if (interval < MIN_REFRESH_MILLIS) {
+			// e.g. vsync forced off by the driver, or a hidden or minimized window
+			if (++pacer->vsyncMisses == VSYNC_MISSES_TO_GIVE_UP) {
+				pacer->mode = PresentMode::PACED;
+				pacer->refreshMillis = TARGET_MILLIS_PER_FRAME;
+				pacer->steps = 1;
+				SDL_Log("presents are not waiting for vsync, pacing frames by sleeping");
+			}
+		}
+		else {
+			pacer->vsyncMisses = 0;
+			// a frame that missed a refresh took several, it says nothing about the interval
+			if (interval < pacer->refreshMillis * 1.5) {
+				pacer->refreshMillis += (interval - pacer->refreshMillis) / 16;
+			}
+		}
+	}
+	pacer->previousPresent = presentEnd;
+}
+
+float EndPacedFrame(FramePacer* pacer) {
+	double frameMillis = ToMillis(SDL_GetPerformanceCounter() - pacer->frameStart);
+	switch (pacer->mode) {
+	case PresentMode::VSYNC:
+		// the refresh interval while the frames keep up with the display, so the steps do not jitter
+		pacer->steps = AdvanceFixedStepClock(&pacer->stepClock, frameMillis < pacer->refreshMillis * 1.5 ? pacer->refreshMillis : frameMillis);
+		return TARGET_MILLIS_PER_FRAME / (float)1000;
+	case PresentMode::PACED:
+		if (frameMillis < TARGET_MILLIS_PER_FRAME) {
+			SDL_Delay((Uint32)(TARGET_MILLIS_PER_FRAME - frameMillis));
+			return TARGET_MILLIS_PER_FRAME / (float)1000;
+		}
+		return (float)frameMillis / 1000;
+	default:
+		// the game moves in whole pixels per step, tiny steps would not move it at all, so uncapped frames
+		// step by the target frame time and the game runs faster than real time
+		return TARGET_MILLIS_PER_FRAME / (float)1000;
+	}
+}
+
+void ResetFramePacerReport(FramePacer* pacer) {
+	pacer->reportStart = SDL_GetPerformanceCounter();
+	pacer->frames = 0;
+	pacer->presentMillis = 0.0;
+	pacer->maxPresentMillis = 0.0;
+	pacer->latencyMillis = 0.0;
+	pacer->maxLatencyMillis = 0.0;
+}
+
+void ReportFramePacer(FramePacer* pacer) {
+	if (pacer->frames > 0) {
+		double seconds = ToMillis(SDL_GetPerformanceCounter() - pacer->reportStart) / 1000;
+		SDL_Log("%s presentation, %.2f ms refresh: %.1f fps, present %.2f ms (max %.2f), frame start to presented %.2f ms (max %.2f)",
+			GetPresentModeName(pacer->mode), pacer->refreshMillis, pacer->frames / seconds, pacer->presentMillis / pacer->frames,
+			pacer->maxPresentMillis, pacer->latencyMillis / pacer->frames, pacer->maxLatencyMillis);
+	}
+	ResetFramePacerReport(pacer);
+}
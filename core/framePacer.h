@@ -0,0 +1,72 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <SDL.h>
+
+#include "game.h"
+
+// How finished frames reach the screen and what paces the frame loop
+enum class PresentMode {
+	AUTO = 0, // only as a request: vsync if the renderer has it and it holds, paced otherwise
+	VSYNC, // SDL_RenderPresent waits for the display, the loop does not sleep and runs fixed steps (FixedStepClock)
+	PACED, // no vsync, the loop sleeps to TARGET_MILLIS_PER_FRAME
+	UNCAPPED // neither, as many frames as the hardware manages
+};
+
+const char* GetPresentModeName(PresentMode mode);
+
+// "auto", "vsync", "paced" or "uncapped", false for anything else
+bool ParsePresentMode(const char* name, PresentMode* mode);
+
+// Flags to add to SDL_CreateRenderer() for the requested mode. Vsync can only be asked for when the renderer
+// is created, InitFramePacer() then checks what the renderer actually does
+Uint32 GetPresentRendererFlags(PresentMode requested);
+
+// presents returning this much faster than the refresh interval, in a row, mean vsync is not holding
+const int VSYNC_MISSES_TO_GIVE_UP = 30;
+// no display refreshes faster, a shorter interval between presents is not vsync
+const double MIN_REFRESH_MILLIS = 2.5;
+
+// Presents frames in the chosen mode, measures the refresh interval while vsync is on and the presentation
+// latency in every mode. Times come from the performance counter
+struct FramePacer {
+	PresentMode mode;
+	// game steps to run in the next frame, each by EndPacedFrame()'s time delta. 1 unless vsync, where a frame
+	// runs 0 or more steps of FIXED_STEP_MILLIS
+	int steps;
+	FixedStepClock stepClock;
+	// measured interval between presents with vsync, the target frame time when paced, 0 uncapped
+	double refreshMillis;
+	Uint64 frameStart;
+	Uint64 previousPresent;
+	double lastPresentMillis; // the newest frame's, blocked in SDL_RenderPresent
+	int vsyncMisses;
+	// since the last report
+	Uint64 reportStart;
+	Uint32 frames;
+	double presentMillis; // blocked in SDL_RenderPresent
+	double maxPresentMillis;
+	double latencyMillis; // frame start (the input is read then) to SDL_RenderPresent returned
+	double maxLatencyMillis;
+};
+
+// Settles the requested mode against the renderer: vsync (asked for or AUTO) falls back to paced without
+// the renderer's SDL_RENDERER_PRESENTVSYNC
+void InitFramePacer(FramePacer* pacer, SDL_Renderer* renderer, PresentMode requested);
+
+// At the top of the frame loop, before the input is read
+void BeginPacedFrame(FramePacer* pacer);
+
+// SDL_RenderPresent(), timed. Gives up on vsync once presents stop waiting for the display
+void PresentPacedFrame(FramePacer* pacer, SDL_Renderer* renderer);
+
+// Sleeps what is left of the frame when paced, sets the steps of the next frame and returns their time delta (seconds)
+float EndPacedFrame(FramePacer* pacer);
+
+// Drops what was measured since the previous report
+void ResetFramePacerReport(FramePacer* pacer);
+
+// Logs the mode, refresh interval and presentation latency since the previous report, and starts a new one
+void ReportFramePacer(FramePacer* pacer);
+
+#endif
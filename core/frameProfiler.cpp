@@ -0,0 +1,102 @@
+#include "frameProfiler.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "allocationCounter.h"
+
+const char* const FRAME_PHASE_NAMES[PHASE_COUNT] = { "input", "simulate", "draw", "present" };
+
+static double ElapsedMillis(Uint64 from, Uint64 to) {
+	return (to - from) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// value below which the given fraction of the values fall, reorders values
+static double Percentile(std::vector<double>& values, double fraction) {
+	if (values.empty()) {
+		return 0.0;
+	}
+
+	size_t index = (size_t)(fraction * (values.size() - 1) + 0.5);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+void InitFrameProfiler(FrameProfiler* profiler, size_t expectedFrames) {
+	profiler->samples.clear();
+	profiler->samples.reserve(expectedFrames);
+	profiler->frameStart = 0;
+	profiler->phaseStart = 0;
+	profiler->allocationsAtStart = 0;
+}
+
+void BeginFrame(FrameProfiler* profiler) {
+	profiler->current = FrameSample{ { 0.0 }, 0.0, 0 };
+	profiler->frameStart = SDL_GetPerformanceCounter();
+	profiler->phaseStart = profiler->frameStart;
+	profiler->allocationsAtStart = GetAllocationCount();
+}
+
+void EndPhase(FrameProfiler* profiler, FramePhase phase) {
+	Uint64 now = SDL_GetPerformanceCounter();
+	profiler->current.phaseMillis[phase] += ElapsedMillis(profiler->phaseStart, now);
+	profiler->phaseStart = now;
+}
+
+void EndFrame(FrameProfiler* profiler) {
+	profiler->current.frameMillis = ElapsedMillis(profiler->frameStart, SDL_GetPerformanceCounter());
+	profiler->current.allocations = GetAllocationCount() - profiler->allocationsAtStart;
+	profiler->samples.push_back(profiler->current);
+}
+
+FrameReport BuildFrameReport(const FrameProfiler& profiler) {
+	FrameReport report = FrameReport();
+	report.frames = profiler.samples.size();
+	if (report.frames == 0) {
+		return report;
+	}
+
+	std::vector<double> frameMillis;
+	frameMillis.reserve(report.frames);
+	Uint64 totalAllocations = 0;
+	for (size_t i = 0; i < report.frames; ++i) {
+		const FrameSample& sample = profiler.samples[i];
+		frameMillis.push_back(sample.frameMillis);
+		report.seconds += sample.frameMillis / 1000.0;
+		report.maxFrameMillis = std::max(report.maxFrameMillis, sample.frameMillis);
+		totalAllocations += sample.allocations;
+		report.maxAllocations = std::max(report.maxAllocations, sample.allocations);
+	}
+
+	report.framesPerSecond = report.seconds > 0.0 ? report.frames / report.seconds : 0.0;
+	report.avgFrameMillis = report.seconds * 1000.0 / report.frames;
+	report.p50FrameMillis = Percentile(frameMillis, 0.50);
+	report.p99FrameMillis = Percentile(frameMillis, 0.99);
+	report.allocationsPerFrame = (double)totalAllocations / report.frames;
+
+	std::vector<double> phaseMillis(report.frames);
+	for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+		double total = 0.0;
+		for (size_t i = 0; i < report.frames; ++i) {
+			phaseMillis[i] = profiler.samples[i].phaseMillis[phase];
+			total += phaseMillis[i];
+		}
+		report.avgPhaseMillis[phase] = total / report.frames;
+		report.p99PhaseMillis[phase] = Percentile(phaseMillis, 0.99);
+	}
+
+	return report;
+}
+
+void PrintFrameReport(const FrameReport& report) {
+	printf("frames:               %zu\n", report.frames);
+	printf("time:                 %.3f s\n", report.seconds);
+	printf("frames per second:    %.1f\n", report.framesPerSecond);
+	printf("frame time:           avg %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+		report.avgFrameMillis, report.p50FrameMillis, report.p99FrameMillis, report.maxFrameMillis);
+	for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+		printf("  %-10s          avg %.3f ms, p99 %.3f ms\n", FRAME_PHASE_NAMES[phase], report.avgPhaseMillis[phase], report.p99PhaseMillis[phase]);
+	}
+	printf("allocations / frame:  avg %.2f, max %u\n", report.allocationsPerFrame, (unsigned int)report.maxAllocations);
+}
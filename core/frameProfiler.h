@@ -0,0 +1,64 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <SDL.h>
+
+// Phases of a single iteration of the frame loop, in the order they run
+enum FramePhase {
+	PHASE_INPUT = 0,
+	PHASE_SIMULATE,
+	PHASE_DRAW,
+	PHASE_PRESENT,
+	PHASE_COUNT
+};
+
+extern const char* const FRAME_PHASE_NAMES[PHASE_COUNT];
+
+struct FrameSample {
+	double phaseMillis[PHASE_COUNT];
+	double frameMillis;
+	Uint32 allocations;
+};
+
+// Times every phase of every frame with the high resolution performance counter.
+// Samples are stored up front so profiling does not allocate while the frame loop runs
+struct FrameProfiler {
+	std::vector<FrameSample> samples;
+	FrameSample current;
+	Uint64 frameStart;
+	Uint64 phaseStart;
+	Uint32 allocationsAtStart;
+};
+
+struct FrameReport {
+	size_t frames;
+	double seconds;
+	double framesPerSecond;
+	double avgFrameMillis;
+	double p50FrameMillis;
+	double p99FrameMillis;
+	double maxFrameMillis;
+	double avgPhaseMillis[PHASE_COUNT];
+	double p99PhaseMillis[PHASE_COUNT];
+	double allocationsPerFrame;
+	Uint32 maxAllocations;
+};
+
+void InitFrameProfiler(FrameProfiler* profiler, size_t expectedFrames);
+
+void BeginFrame(FrameProfiler* profiler);
+
+// Ends the given phase, it lasted from the end of the previous phase (or the start of the frame) until now
+void EndPhase(FrameProfiler* profiler, FramePhase phase);
+
+void EndFrame(FrameProfiler* profiler);
+
+FrameReport BuildFrameReport(const FrameProfiler& profiler);
+
+void PrintFrameReport(const FrameReport& report);
+
+#endif
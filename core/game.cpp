@@ -0,0 +1,620 @@
+#include "game.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const std::unordered_map<ColorLabel, int>& getScoresTable() {
+	// static lifetime -- will be created once and destroyed when application closes
+	static std::unordered_map<ColorLabel, int> scoresTable;
+	if (scoresTable.empty()) {
+		scoresTable[ColorLabel::PINK] = 8;
+		scoresTable[ColorLabel::RED] = 7;
+		scoresTable[ColorLabel::ORANGE] = 6;
+		scoresTable[ColorLabel::YELLOW] = 5;
+		scoresTable[ColorLabel::GREEN] = 4;
+		scoresTable[ColorLabel::BLUE] = 3;
+		scoresTable[ColorLabel::PURPLE] = 2;
+		scoresTable[ColorLabel::CYAN] = 1;
+	}
+
+	return scoresTable;
+}
+
+// '#' is a brick, '2' a durable brick and 'X' an indestructible one, rows from the top
+static const char* const LEVEL_LAYOUTS[LEVEL_COUNT][LAYERS] = {
+	{
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+	},
+	{
+		"2.2.2.2.2.2.2",
+		".#.#.#.#.#.#.",
+		"#.#.#.#.#.#.#",
+		".#.#.#.#.#.#.",
+		"#.#.#.#.#.#.#",
+		".#.#.#.#.#.#.",
+		"#.#.#.#.#.#.#",
+		".#.#.#.#.#.#.",
+	},
+	{
+		"......2......",
+		".....222.....",
+		"....#####....",
+		"...#######...",
+		"..#########..",
+		".###########.",
+		"#############",
+		"X.X.X...X.X.X",
+	},
+	{
+		"#############",
+		"#2#2#2#2#2#2#",
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+		"#############",
+		"XXXX#####XXXX",
+	},};
+
+struct LevelBoards {
+	LevelBoard boards[LEVEL_COUNT];
+};
+
+static LevelBoards LayOutLevelBoards() {
+	LevelBoards levels;
+	for (int level = 0; level < LEVEL_COUNT; ++level) {
+		LevelBoard& board = levels.boards[level];
+		board.bricksLeft = 0;
+		for (int i = 0; i < BRICKS_COUNT; ++i) {
+			int layer = i / BRICKS_PER_LAYER;
+			switch (LEVEL_LAYOUTS[level][layer][i % BRICKS_PER_LAYER]) {
+			case '#':
+				board.brickStates[i] = MakeBrickState(BrickType::NORMAL, 1, layer);
+				++board.bricksLeft;
+				break;
+			case '2':
+				board.brickStates[i] = MakeBrickState(BrickType::DURABLE, DURABLE_BRICK_HIT_POINTS, layer);
+				++board.bricksLeft;
+				break;
+			case 'X':
+				board.brickStates[i] = MakeBrickState(BrickType::INDESTRUCTIBLE, 1, layer);
+				break;
+			default:
+				board.brickStates[i] = MakeBrickState(BrickType::NORMAL, 0, layer);
+				break;
+			}
+		}
+	}
+	return levels;
+}
+
+const LevelBoard& GetLevelBoard(int level) {
+	// static lifetime, laid out on first use (thread safe, games may be stepped on several threads)
+	static const LevelBoards levels = LayOutLevelBoards();
+	return levels.boards[level % LEVEL_COUNT];
+}
+
+// blends the color towards target, amount from 0 (color) to 256 (target)
+static SDL_Color BlendColor(const SDL_Color& color, const SDL_Color& target, int amount) {
+	return SDL_Color{
+		(Uint8)(color.r + (target.r - color.r) * amount / 256),
+		(Uint8)(color.g + (target.g - color.g) * amount / 256),
+		(Uint8)(color.b + (target.b - color.b) * amount / 256),
+		255
+	};
+}
+
+struct BrickPalette {
+	SDL_Color colors[BRICK_STATE_COUNT];
+};
+
+static BrickPalette MakeBrickPalette() {
+	const SDL_Color WHITE{ 255, 255, 255, 255 };
+	const SDL_Color BLACK{ 0, 0, 0, 255 };
+	const SDL_Color GRAY{ 150, 150, 150, 255 };
+
+	BrickPalette palette;
+	for (int state = 0; state < BRICK_STATE_COUNT; ++state) {
+		const SDL_Color& color = BRICK_COLORS[GetBrickLayer((BrickState)state)];
+		switch (GetBrickType((BrickState)state)) {
+		case BrickType::DURABLE:
+			// full strength is lighter, every hit taken darkens it
+			palette.colors[state] = GetBrickHitPoints((BrickState)state) >= DURABLE_BRICK_HIT_POINTS ? BlendColor(color, WHITE, 96) : BlendColor(color, BLACK, 112);
+			break;
+		case BrickType::INDESTRUCTIBLE:
+			palette.colors[state] = GRAY;
+			break;
+		default:
+			palette.colors[state] = color;
+			break;
+		}
+	}
+	return palette;
+}
+
+const SDL_Color* GetBrickPalette() {
+	static const BrickPalette palette = MakeBrickPalette();
+	return palette.colors;
+}
+
+int GetLevelBallSpeed(int level) {
+	return SDL_min(BALL_SPEED + level * LEVEL_BALL_SPEEDUP, MAX_BALL_SPEED);
+}
+
+void initBrickPositions(SDL_Rect* bricks, int layerCount, int bricksPerLayer, int width, int height, int horizPadding, int vertPadding) {
+	for (int i = 0; i < layerCount; ++i) {
+		for (int j = 0; j < bricksPerLayer; ++j) {
+			bricks[i * bricksPerLayer + j] = {
+				(j * (width + horizPadding)) + BRICKS_LEFT_OFFSET,
+				(i * (height + vertPadding)) + vertPadding + CEILING_OFFSET,
+				width,
+				height
+			};
+		}
+	}
+}
+
+bool canRectanglesOverlap(const SDL_Rect& r1, const SDL_Rect& r2) {
+	return (
+		// Horizontal component
+		r1.x < r2.x + r2.w && r1.x + r1.w > r2.x &&
+		// Vertical component
+		r1.y < r2.y + r2.h && r1.y + r1.h > r2.y
+	);
+}
+
+bool IsBrickHit(BrickState brick, const SDL_Rect& brickRect, const SDL_Rect& ball, float yVel) {
+	if (GetBrickHitPoints(brick) == 0 || !canRectanglesOverlap(ball, brickRect)) {
+		return false;
+	}
+	// the hit destroys it
+	if (GetBrickHitPoints(DamageBrick(brick)) == 0) {
+		return true;
+	}
+
+	// the ball already bounced off the brick and is on its way out
+	int ballCenter = ball.y * 2 + ball.h;
+	int brickCenter = brickRect.y * 2 + brickRect.h;
+	return yVel > 0 ? ballCenter < brickCenter : ballCenter > brickCenter;
+}
+
+int checkBrickCollision(SDL_Rect* bricks, BrickState* brickStates, int bricksCount, const SDL_Rect& ball, float xVel, float yVel) {
+	for (int i = 0; i < bricksCount; ++i) {
+		BrickState brick = brickStates[i];
+		// skip to the next brick if it was destroyed already
+		if (GetBrickHitPoints(brick) == 0) {
+			continue;
+		}
+
+		// Needs improvement: (Ball moving diagonally will sometimes will fail the collision detection
+		// check and cause the ball to go through the next set of bricks above the brick we just hit)
+		// Collision detection can be more accurate by calculating
+		// the point of intersection between a projected point and edge of a brick
+		// What can I do with point of intersection?
+		// Can correct the position of the brick (1 frame) so that it doesn't pass over bricks
+		// it should have not hit in the upcoming frames by setting the ball's position to
+		// the point of intersection
+		// See: https://codeincomplete.com/articles/collision-detection-in-breakout/
+		// IsBrickHit() starts with the overlap test
+		if (IsBrickHit(brick, bricks[i], ball, yVel)) {
+			brickStates[i] = DamageBrick(brick);
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void ResetBallPosition(SDL_Rect* ball) {
+	ball->x = (GAME_WIDTH - ball->w) / 2;
+	ball->y = (GAME_HEIGHT - ball->h) / 2;
+}
+
+void SetRandomBallDirection(int* xDir, int* yDir) {
+	int directions[2] = { -1, 1 };
+	*xDir = directions[rand() % 2];
+	*yDir = 1;
+}
+
+// xorshift32 for seeded games, so they neither share nor race on the rand() state
+static Uint32 NextRandomNumber(Uint32* randomState) {
+	if (*randomState == 0) {
+		return (Uint32)rand();
+	}
+
+	Uint32 x = *randomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*randomState = x;
+	return x;
+}
+
+void SetSeededBallDirection(Uint32* randomState, int* xDir, int* yDir) {
+	if (*randomState == 0) {
+		SetRandomBallDirection(xDir, yDir);
+		return;
+	}
+
+	*xDir = (NextRandomNumber(randomState) >> 31) ? 1 : -1;
+	*yDir = 1;
+}
+
+static void RandomizeBallDirection(GameState* state) {
+	SetSeededBallDirection(&state->randomState, &state->xDirection, &state->yDirection);
+}
+
+// keeps the paddle's center where it is
+static void SetPaddleWidth(GameState* state, int width) {
+	state->paddle.x += (state->paddle.w - width) / 2;
+	state->paddle.w = width;
+}
+
+// Ends every effect and clears the extra balls, falling power-ups and laser shots.
+// The paddle width and the ball speed go back to the level's
+static void EndPowerUps(GameState* state) {
+	if (state->paddle.w != PADDLE_WIDTH) {
+		SetPaddleWidth(state, PADDLE_WIDTH);
+	}
+	state->ballSpeed = GetLevelBallSpeed(state->level);
+	state->extraBallCount = 0;
+	ClearEntities(&state->entities);
+	ClearEffectWheel(&state->effects);
+}
+
+void StartLevel(GameState* state, int level) {
+	const LevelBoard& board = GetLevelBoard(level);
+	memcpy(state->brickStates, board.brickStates, sizeof(state->brickStates));
+	state->bricksLeft = board.bricksLeft;
+	state->level = level;
+	EndPowerUps(state);
+
+	ResetBallPosition(&state->ball);
+	RandomizeBallDirection(state);
+	ResetPaddlePosition(&state->paddle);
+	state->paddleRemainder = 0.0f;
+}
+
+void ResetGame(int* score, int* lives, bool* isGameOver, SDL_Rect* ball, int* xDir, int* yDir) {
+	*score = 0;
+	*lives = STARTING_LIVES;
+	*isGameOver = false;
+
+	ResetBallPosition(ball);
+	SetRandomBallDirection(xDir, yDir);
+}
+
+void ResetBrickMap(BrickState* bricks) {
+	for (int i = 0; i < BRICKS_COUNT; ++i) {
+		bricks[i] = MakeBrickState(BrickType::NORMAL, 1, i / BRICKS_PER_LAYER);
+	}
+}
+
+void ResetPaddlePosition(SDL_Rect* paddle) {
+	paddle->x = (GAME_WIDTH - paddle->w) / 2;
+}
+
+void InitGame(GameState* state) {
+	InitSeededGame(state, 0);
+}
+
+void InitSeededGame(GameState* state, Uint32 seed) {
+	state->randomState = seed;
+	state->score = 0;
+	state->lives = STARTING_LIVES;
+	state->isGameOver = false;
+	state->isGamePaused = false;
+	state->arePowerUpsEnabled = true;
+
+	state->paddle = { (GAME_WIDTH - PADDLE_WIDTH) / 2, (GAME_HEIGHT - PADDLE_HEIGHT) - 20, PADDLE_WIDTH, PADDLE_HEIGHT };
+	state->paddleSpeed = PADDLE_SPEED;
+	state->ball = { (GAME_WIDTH - BALL_WIDTH) / 2, (GAME_HEIGHT - BALL_HEIGHT) / 2, BALL_WIDTH, BALL_HEIGHT };
+
+	// the brick rectangles are the same on every level, only the brick states change
+	initBrickPositions(state->bricks, LAYERS, BRICKS_PER_LAYER, BRICK_WIDTH, BRICK_HEIGHT, BRICK_HORIZ_PADDING, BRICK_VERT_PADDING);
+	StartLevel(state, 0);
+}
+
+static void DropPowerUp(GameState* state, const SDL_Rect& brick) {
+	if (NextRandomNumber(&state->randomState) % POWER_UP_DROP_ODDS != 0) {
+		return;
+	}
+
+	EntityKind kind = (EntityKind)(NextRandomNumber(&state->randomState) % POWER_UP_KIND_COUNT);
+	SpawnEntity(&state->entities, kind, brick.x + (brick.w - POWER_UP_WIDTH) / 2, brick.y);
+}
+
+// Scores the hit brick and, once it is destroyed, drops a power-up or moves on to the next level.
+// Returns true for the latter
+static bool OnBrickHit(GameState* state, int brickIndex) {
+	BrickState brick = state->brickStates[brickIndex];
+	if (GetBrickType(brick) == BrickType::INDESTRUCTIBLE) {
+		return false;
+	}
+
+	// update score, every hit point taken counts
+	state->score += getScoresTable().at((ColorLabel)GetBrickLayer(brick));
+	if (GetBrickHitPoints(brick) != 0) {
+		return false;
+	}
+
+	// level cleared, the next board is ready to be copied in
+	if (--state->bricksLeft == 0) {
+		StartLevel(state, state->level + 1);
+		return true;
+	}
+	if (state->arePowerUpsEnabled) {
+		DropPowerUp(state, state->bricks[brickIndex]);
+	}
+	return false;
+}
+
+static void ApplyPowerUp(GameState* state, EntityKind kind) {
+	switch (kind) {
+	case EntityKind::WIDE_PADDLE:
+		SetPaddleWidth(state, WIDE_PADDLE_WIDTH);
+		ScheduleEvent(&state->effects, TimerEvent::WIDE_PADDLE_ENDS, WIDE_PADDLE_TICKS);
+		break;
+	case EntityKind::SLOW_BALL:
+		state->ballSpeed = SLOW_BALL_SPEED;
+		ScheduleEvent(&state->effects, TimerEvent::SLOW_BALL_ENDS, SLOW_BALL_TICKS);
+		break;
+	case EntityKind::MULTI_BALL: {
+		// from where the ball is, heading the other ways
+		const int DIRECTIONS[MAX_EXTRA_BALLS][2] = { { -1, 1 }, { 1, -1 } };
+		for (int i = state->extraBallCount; i < MAX_EXTRA_BALLS; ++i) {
+			state->extraBalls[i] = state->ball;
+			state->extraXDirections[i] = DIRECTIONS[i][0] * state->xDirection;
+			state->extraYDirections[i] = DIRECTIONS[i][1] * state->yDirection;
+		}
+		state->extraBallCount = MAX_EXTRA_BALLS;
+		break;
+	}
+	case EntityKind::LASER:
+		ScheduleEvent(&state->effects, TimerEvent::LASER_ENDS, LASER_TICKS);
+		if (!IsEventPending(state->effects, TimerEvent::LASER_FIRES)) {
+			ScheduleEvent(&state->effects, TimerEvent::LASER_FIRES, 1);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void HandleTimerEvents(GameState* state, Uint32 dueEvents) {
+	if (dueEvents & (1 << (int)TimerEvent::WIDE_PADDLE_ENDS)) {
+		SetPaddleWidth(state, PADDLE_WIDTH);
+	}
+	if (dueEvents & (1 << (int)TimerEvent::SLOW_BALL_ENDS)) {
+		state->ballSpeed = GetLevelBallSpeed(state->level);
+	}
+	if (dueEvents & (1 << (int)TimerEvent::LASER_ENDS)) {
+		CancelEvent(&state->effects, TimerEvent::LASER_FIRES);
+	}
+	else if (dueEvents & (1 << (int)TimerEvent::LASER_FIRES)) {
+		// from both ends of the paddle
+		const SDL_Rect& paddle = state->paddle;
+		SpawnEntity(&state->entities, EntityKind::LASER_SHOT, paddle.x + LASER_SHOT_WIDTH, paddle.y - LASER_SHOT_HEIGHT);
+		SpawnEntity(&state->entities, EntityKind::LASER_SHOT, paddle.x + paddle.w - 2 * LASER_SHOT_WIDTH, paddle.y - LASER_SHOT_HEIGHT);
+		ScheduleEvent(&state->effects, TimerEvent::LASER_FIRES, LASER_FIRE_TICKS);
+	}
+}
+
+// Moves extra ball i the way StepGame() moves the ball, returns false once it is lost
+static bool StepExtraBall(GameState* state, int i, float timeDelta) {
+	SDL_Rect& ball = state->extraBalls[i];
+	int& xDirection = state->extraXDirections[i];
+	int& yDirection = state->extraYDirections[i];
+	float xVel = xDirection * state->ballSpeed * timeDelta;
+	float yVel = yDirection * state->ballSpeed * timeDelta;
+
+	if (ball.x + xVel < 0) {
+		xDirection *= -1;
+	}
+	if (ball.x + ball.w + xVel > GAME_WIDTH) {
+		xDirection *= -1;
+	}
+	if (ball.y + ball.h + yVel > GAME_HEIGHT) {
+		return false;
+	}
+	if (ball.y + yVel < CEILING_OFFSET) {
+		yDirection = 1;
+	}
+	if (canRectanglesOverlap(ball, state->paddle)) {
+		yDirection *= -1;
+	}
+
+	int brickIndex = checkBrickCollision(state->bricks, state->brickStates, BRICKS_COUNT, ball, xVel, yDirection * state->ballSpeed * timeDelta);
+	if (brickIndex != -1) {
+		yDirection *= -1;
+		if (OnBrickHit(state, brickIndex)) {
+			return true;
+		}
+	}
+
+	ball.x += xDirection * state->ballSpeed * timeDelta;
+	ball.y += yDirection * state->ballSpeed * timeDelta;
+	return true;
+}
+
+// Extra balls, falling power-ups, laser shots and effect timers. Stops early if the level is cleared on the way
+static void StepPowerUps(GameState* state, float timeDelta) {
+	int level = state->level;
+	for (int i = state->extraBallCount - 1; i >= 0; --i) {
+		bool isInPlay = StepExtraBall(state, i, timeDelta);
+		if (state->level != level) {
+			return;
+		}
+		if (!isInPlay) {
+			--state->extraBallCount;
+			state->extraBalls[i] = state->extraBalls[state->extraBallCount];
+			state->extraXDirections[i] = state->extraXDirections[state->extraBallCount];
+			state->extraYDirections[i] = state->extraYDirections[state->extraBallCount];
+		}
+	}
+
+	EntityPool& entities = state->entities;
+	Uint32 removed = 0;
+	for (int i = 0; i < entities.count; ++i) {
+		if (entities.kinds[i] != EntityKind::LASER_SHOT) {
+			entities.y[i] += POWER_UP_FALL_SPEED * timeDelta;
+			if (entities.y[i] > GAME_HEIGHT) {
+				removed |= 1u << i;
+			}
+			continue;
+		}
+
+		float yVel = -LASER_SHOT_SPEED * timeDelta;
+		entities.y[i] += yVel;
+		SDL_Rect shot = GetEntityRect(entities, i);
+		int brickIndex = checkBrickCollision(state->bricks, state->brickStates, BRICKS_COUNT, shot, 0.0f, yVel);
+		if (brickIndex != -1 || shot.y + shot.h < CEILING_OFFSET) {
+			removed |= 1u << i;
+		}
+		if (brickIndex != -1 && OnBrickHit(state, brickIndex)) {
+			return;
+		}
+	}
+
+	Uint32 caught = entities.count != 0 ? FindCaughtPowerUps(entities, state->paddle) & ~removed : 0;
+	for (int i = 0; i < entities.count; ++i) {
+		if ((caught >> i) & 1) {
+			ApplyPowerUp(state, entities.kinds[i]);
+		}
+	}
+	RemoveEntities(&entities, removed | caught);
+
+	Uint32 dueEvents = AdvanceEffectWheel(&state->effects, timeDelta);
+	if (dueEvents != 0) {
+		HandleTimerEvents(state, dueEvents);
+	}
+}
+
+int StepGame(GameState* state, const GameInput& input, float timeDelta) {
+	if (state->isGameOver && input.restart)
+	{
+		state->score = 0;
+		state->lives = STARTING_LIVES;
+		state->isGameOver = false;
+		StartLevel(state, 0);
+	}
+
+	// toggle pause
+	if (!state->isGameOver && input.togglePause)
+	{
+		state->isGamePaused = !state->isGamePaused;
+	}
+
+	SDL_Rect& ball = state->ball;
+	float xVel = state->xDirection * state->ballSpeed * timeDelta;
+	float yVel = state->yDirection * state->ballSpeed * timeDelta;
+
+	// Screen Bounds Ball Collision Check
+	{
+		if (ball.x + xVel < 0)
+		{
+			state->xDirection *= -1;
+		}
+
+		if (ball.x + ball.w + xVel > GAME_WIDTH)
+		{
+			state->xDirection *= -1;
+		}
+
+		// lose live condition
+		if (ball.y + ball.h + yVel > GAME_HEIGHT && state->extraBallCount > 0)
+		{
+			// another ball is still in play and takes over
+			--state->extraBallCount;
+			ball = state->extraBalls[state->extraBallCount];
+			state->xDirection = state->extraXDirections[state->extraBallCount];
+			state->yDirection = state->extraYDirections[state->extraBallCount];
+		}
+		else if (ball.y + ball.h + yVel > GAME_HEIGHT)
+		{
+			if (state->lives - 1 >= 0) {
+				--state->lives;
+			}
+
+			if (state->lives > 0) {
+				RandomizeBallDirection(state);
+				ResetBallPosition(&ball);
+			}
+			else {
+				state->isGameOver = true;
+			}
+
+			// the power-ups go with the ball
+			if (state->arePowerUpsEnabled) {
+				EndPowerUps(state);
+			}
+		}
+
+		// always down, a brick hit in the same step must not turn the ball back above the ceiling
+		if (ball.y + yVel < CEILING_OFFSET)
+		{
+			state->yDirection = 1;
+		}
+	}
+
+	// Ball to Paddle Collision Check
+	{
+		if (canRectanglesOverlap(ball, state->paddle)) {
+			state->yDirection *= -1;
+		}
+	}
+
+	// the direction after the wall and paddle bounces tells whether the ball is leaving a brick it hit before
+	float brickYVel = state->yDirection * state->ballSpeed * timeDelta;
+	int brickIndex = checkBrickCollision(state->bricks, state->brickStates, BRICKS_COUNT, ball, xVel, brickYVel);
+	if (brickIndex != -1) {
+		state->yDirection *= -1;
+		OnBrickHit(state, brickIndex);
+	}
+
+	// Move Objects
+	{
+		if (!state->isGameOver && !state->isGamePaused) {
+			state->paddleRemainder += state->paddleSpeed * input.paddleTravel;
+			int paddleStep = (int)state->paddleRemainder;
+			state->paddle.x += paddleStep;
+			state->paddleRemainder -= paddleStep;
+		}
+		else {
+			state->paddleRemainder = 0.0f;
+		}
+
+		if (!state->isGamePaused) {
+			ball.x += state->xDirection * state->ballSpeed * timeDelta;
+			ball.y += state->yDirection * state->ballSpeed * timeDelta;
+		}
+	}
+
+	if (state->arePowerUpsEnabled && !state->isGameOver && !state->isGamePaused) {
+		StepPowerUps(state, timeDelta);
+	}
+
+	return brickIndex;
+}
+
+int AdvanceFixedStepClock(FixedStepClock* clock, double frameMillis) {
+	if (frameMillis > FIXED_STEP_MILLIS * (1 - FIXED_STEP_SNAP_TOLERANCE) && frameMillis < FIXED_STEP_MILLIS * (1 + FIXED_STEP_SNAP_TOLERANCE)) {
+		return 1;
+	}
+
+	clock->leftoverMillis += frameMillis;
+	int steps = (int)(clock->leftoverMillis / FIXED_STEP_MILLIS);
+	if (steps > MAX_FIXED_STEPS_PER_FRAME) {
+		clock->leftoverMillis = 0.0;
+		return MAX_FIXED_STEPS_PER_FRAME;
+	}
+	clock->leftoverMillis -= steps * FIXED_STEP_MILLIS;
+	return steps;
+}
@@ -0,0 +1,243 @@
+#ifndef GAME_H
+#define GAME_H
+
+// Gameplay logic shared by the windows/linux and psvita builds.
+// Only the SDL types are used here so this builds without linking SDL
+#include <SDL_rect.h>
+#include <SDL_pixels.h>
+
+#include <unordered_map>
+
+#include "powerUps.h"
+
+// PS VITA SCREEN DIMENSIONS
+// (not named SCREEN_WIDTH/SCREEN_HEIGHT as debugScreen.h defines macros with those names)
+const int GAME_WIDTH = 960;
+const int GAME_HEIGHT = 544;
+
+const int TARGET_FRAME_RATE = 60;
+const int TARGET_MILLIS_PER_FRAME = ((float)1 / TARGET_FRAME_RATE) * 1000;
+
+const int STARTING_LIVES = 3;
+// measured in meters per second
+const int BALL_SPEED = 250;
+const int BALL_WIDTH = 15;
+const int BALL_HEIGHT = 15;
+
+const int PADDLE_WIDTH = 150;
+const int PADDLE_HEIGHT = 20;
+const int PADDLE_SPEED = 1000;
+
+const int BRICKS_PER_LAYER = 13;
+const int LAYERS = 8;
+const int BRICKS_COUNT = BRICKS_PER_LAYER * LAYERS;
+const int BRICK_WIDTH = 70;
+const int BRICK_HEIGHT = 15;
+const int BRICK_HORIZ_PADDING = 3;
+const int BRICK_VERT_PADDING = 5;
+const int CEILING_OFFSET = 30;
+// x of the first brick column
+const int BRICKS_LEFT_OFFSET = 6;
+// the bricks form a grid, cells include the padding after the brick
+const int BRICK_COLUMN_STRIDE = BRICK_WIDTH + BRICK_HORIZ_PADDING;
+const int BRICK_ROW_STRIDE = BRICK_HEIGHT + BRICK_VERT_PADDING;
+const int BRICKS_TOP = BRICK_VERT_PADDING + CEILING_OFFSET;
+const int BRICKS_BOTTOM = BRICKS_TOP + LAYERS * BRICK_ROW_STRIDE;
+
+// Levels differ in the bricks they start with and the ball speed. After the last one the layouts
+// start over, with the ball still getting faster up to MAX_BALL_SPEED
+const int LEVEL_COUNT = 4;
+// balls move in whole pixels, so at 60 fps the speed only matters in steps of 60
+const int LEVEL_BALL_SPEEDUP = 60;
+const int MAX_BALL_SPEED = BALL_SPEED + 3 * LEVEL_BALL_SPEEDUP;
+
+// one destroyed brick in POWER_UP_DROP_ODDS drops a power-up
+const int POWER_UP_DROP_ODDS = 6;
+const int WIDE_PADDLE_WIDTH = PADDLE_WIDTH * 3 / 2;
+const int SLOW_BALL_SPEED = BALL_SPEED - LEVEL_BALL_SPEEDUP;
+// balls the multi-ball power-up adds
+const int MAX_EXTRA_BALLS = 2;
+// effect durations in EFFECT_TICK_MILLIS ticks
+const int WIDE_PADDLE_TICKS = 200;
+const int SLOW_BALL_TICKS = 160;
+const int LASER_TICKS = 120;
+const int LASER_FIRE_TICKS = 8;
+
+const SDL_Color CYAN { 0, 255, 255, 255 };
+const SDL_Color PURPLE { 128, 0, 128, 255 };
+const SDL_Color BLUE { 0, 0, 255, 255 };
+const SDL_Color GREEN { 0, 255, 0, 255 };
+const SDL_Color YELLOW { 255, 255, 0, 255 };
+const SDL_Color ORANGE { 255, 165, 0, 255 };
+const SDL_Color RED { 255, 0, 0, 255 };
+const SDL_Color PINK { 255, 192, 203, 255 };
+
+const SDL_Color BRICK_COLORS[LAYERS] { PINK, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, CYAN };
+
+enum class ColorLabel {
+	PINK = 0, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, CYAN
+};
+
+// Points given for every hit point taken from a brick of each layer
+const std::unordered_map<ColorLabel, int>& getScoresTable();
+
+enum class BrickType {
+	NORMAL = 0,
+	DURABLE, // takes DURABLE_BRICK_HIT_POINTS hits
+	INDESTRUCTIBLE // bounces the ball forever, not needed to clear the level
+};
+
+const int DURABLE_BRICK_HIT_POINTS = 2;
+
+// Everything about a brick in one byte, so collision, scoring and drawing read a single value per brick:
+// bits 0-1 are the hit points left (0 once destroyed), bits 2-3 the BrickType and bits 4-6 the layer,
+// which picks the color and the points
+typedef Uint8 BrickState;
+
+// every value a BrickState can take, e.g. the size of a palette indexed by it
+const int BRICK_STATE_COUNT = 128;
+
+inline BrickState MakeBrickState(BrickType type, int hitPoints, int layer) {
+	return (BrickState)(hitPoints | ((int)type << 2) | (layer << 4));
+}
+
+inline int GetBrickHitPoints(BrickState brick) {
+	return brick & 3;
+}
+
+inline BrickType GetBrickType(BrickState brick) {
+	return (BrickType)((brick >> 2) & 3);
+}
+
+inline int GetBrickLayer(BrickState brick) {
+	return brick >> 4;
+}
+
+// Color of every BrickState: the layer's color, lighter for durable bricks and darker once they are damaged,
+// gray for indestructible ones. Worked out once
+const SDL_Color* GetBrickPalette();
+
+// Everything the main loop needs to simulate a game, independent of the platform
+struct GameState {
+	int score;
+	int lives;
+	bool isGameOver;
+	bool isGamePaused;
+
+	SDL_Rect paddle;
+	int paddleSpeed;
+	// sub-pixel paddle movement left over from previous frames
+	float paddleRemainder;
+
+	SDL_Rect ball;
+	// measured in units per second
+	int ballSpeed;
+	int xDirection;
+	int yDirection;
+
+	SDL_Rect bricks[BRICKS_COUNT];
+	BrickState brickStates[BRICKS_COUNT];
+	// bricks left to destroy, counted down on every hit that destroys one so a cleared level is noticed
+	// without a scan. Indestructible bricks do not count
+	int bricksLeft;
+	// counts from 0
+	int level;
+
+	// xorshift state for the ball directions and power-up drops of this game, 0 uses rand() instead
+	Uint32 randomState;
+
+	bool arePowerUpsEnabled;
+	// more balls from the multi-ball power-up, they move like the ball above but losing them costs no life
+	SDL_Rect extraBalls[MAX_EXTRA_BALLS];
+	int extraXDirections[MAX_EXTRA_BALLS];
+	int extraYDirections[MAX_EXTRA_BALLS];
+	int extraBallCount;
+	// falling power-ups and laser shots
+	EntityPool entities;
+	// ends the effects of the power-ups caught
+	EffectWheel effects;
+};
+
+// Input for a single simulation step, already translated from the platform's input system
+struct GameInput {
+	// signed time (in seconds) the paddle moved at full speed during the step, negative moves left
+	float paddleTravel;
+	bool togglePause;
+	bool restart;
+};
+
+void initBrickPositions(SDL_Rect* bricks, int layerCount, int bricksPerLayer, int width, int height, int horizPadding, int vertPadding);
+
+bool canRectanglesOverlap(const SDL_Rect& r1, const SDL_Rect& r2);
+
+// Takes a hit point, indestructible bricks stay as they are
+inline BrickState DamageBrick(BrickState brick) {
+	return GetBrickType(brick) == BrickType::INDESTRUCTIBLE ? brick : (BrickState)(brick - 1);
+}
+
+// Whether the ball hits the standing brick: it overlaps it and, unless the hit destroys the brick, is not moving
+// away from it (yVel) after bouncing off it, so it is not hit again on the way out
+bool IsBrickHit(BrickState brick, const SDL_Rect& brickRect, const SDL_Rect& ball, float yVel);
+
+// Damages the first brick the ball hits (see IsBrickHit()) and returns its index, -1 if no collision found
+int checkBrickCollision(SDL_Rect* bricks, BrickState* brickStates, int bricksCount, const SDL_Rect& ball, float xVel, float yVel);
+
+void ResetBallPosition(SDL_Rect* ball);
+
+void SetRandomBallDirection(int* xDir, int* yDir);
+
+// Like SetRandomBallDirection() from a game's own xorshift state, falls back to rand() if it is 0
+void SetSeededBallDirection(Uint32* randomState, int* xDir, int* yDir);
+
+void ResetGame(int* score, int* lives, bool* isGameOver, SDL_Rect* ball, int* xDir, int* yDir);
+
+// a full board of normal bricks
+void ResetBrickMap(BrickState* bricks);
+
+void ResetPaddlePosition(SDL_Rect* paddle);
+
+// Board a level starts with, laid out once for all levels and copied into the game when the level begins
+struct LevelBoard {
+	BrickState brickStates[BRICKS_COUNT];
+	int bricksLeft;
+};
+
+// level counts from 0, the layouts repeat after LEVEL_COUNT levels
+const LevelBoard& GetLevelBoard(int level);
+
+int GetLevelBallSpeed(int level);
+
+// Puts the level's board in place and serves the ball from the middle, score and lives carry over and the
+// power-ups end. StepGame() calls it once the last brick of a level is destroyed
+void StartLevel(GameState* state, int level);
+
+// Sets up a new game with all bricks in place, the ball heading in a random direction and power-ups enabled
+void InitGame(GameState* state);
+
+// Like InitGame() but the ball directions come from the game's own random numbers, so games can be
+// simulated side by side (and on several threads) reproducibly. A seed of 0 uses rand() like InitGame()
+void InitSeededGame(GameState* state, Uint32 seed);
+
+// Advances the game by timeDelta seconds.
+// Returns the index of the brick hit during this step or -1 if none was hit
+int StepGame(GameState* state, const GameInput& input, float timeDelta);
+
+// Frames of any length simulated in steps of FIXED_STEP_MILLIS. The ball moves whole pixels per step, so
+// stepping by the frame time (e.g. a 144 Hz display's refresh interval) would change its speed with the frame rate
+struct FixedStepClock {
+	double leftoverMillis; // frame time not stepped yet
+};
+
+// exactly TARGET_FRAME_RATE steps per second, TARGET_MILLIS_PER_FRAME is truncated to 16 and would run an extra
+// step every 24 frames of a 60 Hz display
+const double FIXED_STEP_MILLIS = 1000.0 / TARGET_FRAME_RATE;
+// frames this close to one step (e.g. a 59.94 Hz display, or jitter in the measured refresh interval) run exactly
+// one step, so the game follows the display instead of running a double step every few seconds
+const double FIXED_STEP_SNAP_TOLERANCE = 0.02;
+// after a stall the game skips ahead rather than running more steps than this in one frame
+const int MAX_FIXED_STEPS_PER_FRAME = 4;
+
+// Adds a frame's time and returns how many steps to run for it, 0 to MAX_FIXED_STEPS_PER_FRAME
+int AdvanceFixedStepClock(FixedStepClock* clock, double frameMillis);
+
+#endif
@@ -0,0 +1,237 @@
+#include "gameRenderer.h"
+
+#include <stdio.h>
+
+#include <string>
+
+RenderStats gRenderStats = RenderStats();
+
+TextLabel CreateTextLabelFromSurface(SDL_Renderer* renderer, SDL_Surface* surface) {
+	TextLabel label{ NULL, { 0, 0, 0, 0 } };
+	label.texture = SDL_CreateTextureFromSurface(renderer, surface);
+	++gRenderStats.textureCreations;
+	SDL_QueryTexture(label.texture, NULL, NULL, &(label.rect.w), &(label.rect.h));
+	return label;
+}
+
+TextLabel CreateTextLabel(SDL_Renderer* renderer, TTF_Font* font, const char* text) {
+	SDL_Surface* surf = TTF_RenderText_Solid(font, text, TEXT_COLOR);
+	TextLabel label = CreateTextLabelFromSurface(renderer, surf);
+	SDL_FreeSurface(surf);
+	return label;
+}
+
+void DestroyTextLabel(TextLabel* label) {
+	SDL_DestroyTexture(label->texture);
+	label->texture = NULL;
+}
+
+static TTF_Font* GetFallbackFont(TTFFallback* fallback) {
+	if (fallback != NULL && !fallback->isOpened) {
+		fallback->isOpened = true;
+		fallback->font = fallback->open(fallback->context, fallback->name, fallback->size);
+	}
+	return fallback != NULL ? fallback->font : NULL;
+}
+
+SDL_Surface* RenderUIText(const UIFont& font, const char* text) {
+	if (font.baked != NULL && HasBakedGlyphs(*font.face, text)) {
+		return RenderBakedText(*font.baked, *font.face, text);
+	}
+
+	TTF_Font* ttf = font.ttf != NULL ? font.ttf : GetFallbackFont(font.fallback);
+	if (ttf == NULL && font.baked != NULL) {
+		return RenderBakedText(*font.baked, *font.face, text);
+	}
+	// UTF-8, the same as the Latin-1 of TTF_RenderText_* for ASCII
+	return TTF_RenderUTF8_Solid(ttf, text, TEXT_COLOR);
+}
+
+void RenderGameLabelSurfaces(GameLabelSurfaces* surfaces, const UIFont& font, const UIFont& bigFont, const char* playAgainText, const char* unpauseText) {
+	surfaces->scoreLabel = RenderUIText(font, "Score: ");
+	surfaces->livesLabel = RenderUIText(font, "Lives: ");
+	surfaces->gameOver = RenderUIText(bigFont, "Game Over");
+	surfaces->playAgain = RenderUIText(bigFont, playAgainText);
+	surfaces->gamePause = RenderUIText(bigFont, "Game Paused");
+	surfaces->pauseLabel = RenderUIText(bigFont, unpauseText);
+}
+
+void FreeGameLabelSurfaces(GameLabelSurfaces* surfaces) {
+	SDL_FreeSurface(surfaces->scoreLabel);
+	SDL_FreeSurface(surfaces->livesLabel);
+	SDL_FreeSurface(surfaces->gameOver);
+	SDL_FreeSurface(surfaces->playAgain);
+	SDL_FreeSurface(surfaces->gamePause);
+	SDL_FreeSurface(surfaces->pauseLabel);
+	*surfaces = GameLabelSurfaces{ NULL, NULL, NULL, NULL, NULL, NULL };
+}
+
+void CreateGameLabelsFromSurfaces(SDL_Renderer* renderer, GameLabels* labels, GameLabelSurfaces* surfaces) {
+	labels->scoreLabel = CreateTextLabelFromSurface(renderer, surfaces->scoreLabel);
+	labels->livesLabel = CreateTextLabelFromSurface(renderer, surfaces->livesLabel);
+
+	labels->gameOver = CreateTextLabelFromSurface(renderer, surfaces->gameOver);
+	labels->gameOver.rect.x = (GAME_WIDTH - labels->gameOver.rect.w) / 2;
+	labels->gameOver.rect.y = (GAME_HEIGHT - labels->gameOver.rect.h) / 2;
+
+	labels->playAgain = CreateTextLabelFromSurface(renderer, surfaces->playAgain);
+	labels->playAgain.rect.x = (GAME_WIDTH - labels->playAgain.rect.w) / 2;
+	labels->playAgain.rect.y = (GAME_HEIGHT + labels->gameOver.rect.h + 100 - labels->playAgain.rect.h) / 2;
+
+	labels->gamePause = CreateTextLabelFromSurface(renderer, surfaces->gamePause);
+	labels->gamePause.rect.x = (GAME_WIDTH - labels->gamePause.rect.w) / 2;
+	labels->gamePause.rect.y = (GAME_HEIGHT - labels->gamePause.rect.y) / 2;
+
+	labels->pauseLabel = CreateTextLabelFromSurface(renderer, surfaces->pauseLabel);
+	labels->pauseLabel.rect.x = (GAME_WIDTH - labels->pauseLabel.rect.w) / 2;
+	labels->pauseLabel.rect.y = (GAME_HEIGHT + labels->gamePause.rect.h + 100 - labels->pauseLabel.rect.h) / 2;
+
+	FreeGameLabelSurfaces(surfaces);
+}
+
+void CreateGameLabels(SDL_Renderer* renderer, GameLabels* labels, TTF_Font* font, TTF_Font* bigFont, const char* playAgainText, const char* unpauseText) {
+	GameLabelSurfaces surfaces;
+	RenderGameLabelSurfaces(&surfaces, UIFont{ font, NULL, NULL, NULL }, UIFont{ bigFont, NULL, NULL, NULL }, playAgainText, unpauseText);
+	CreateGameLabelsFromSurfaces(renderer, labels, &surfaces);
+}
+
+void DestroyGameLabels(GameLabels* labels) {
+	DestroyTextLabel(&labels->gameOver);
+	DestroyTextLabel(&labels->gamePause);
+	DestroyTextLabel(&labels->livesLabel);
+	DestroyTextLabel(&labels->pauseLabel);
+	DestroyTextLabel(&labels->playAgain);
+	DestroyTextLabel(&labels->scoreLabel);
+}
+
+void drawBricks(SDL_Renderer* renderer, const SDL_Rect* bricks, const BrickState* brickStates, int bricksCount) {
+	// bricks sorted by state (counting sort), so every color is set once and its bricks filled in one call
+	int offsets[BRICK_STATE_COUNT + 1] = { 0 };
+	for (int i = 0; i < bricksCount; ++i) {
+		++offsets[brickStates[i] + 1];
+	}
+	for (int state = 0; state < BRICK_STATE_COUNT; ++state) {
+		offsets[state + 1] += offsets[state];
+	}
+	SDL_Rect sorted[BRICKS_COUNT];
+	int next[BRICK_STATE_COUNT];
+	SDL_memcpy(next, offsets, sizeof(next));
+	for (int i = 0; i < bricksCount; ++i) {
+		sorted[next[brickStates[i]]++] = bricks[i];
+	}
+
+	const SDL_Color* palette = GetBrickPalette();
+	for (int state = 0; state < BRICK_STATE_COUNT; ++state) {
+		int count = offsets[state + 1] - offsets[state];
+		if (count == 0 || GetBrickHitPoints((BrickState)state) == 0) {
+			continue;
+		}
+		SDL_SetRenderDrawColor(renderer, palette[state].r, palette[state].g, palette[state].b, palette[state].a);
+		SDL_RenderFillRects(renderer, sorted + offsets[state], count);
+		++gRenderStats.drawCalls;
+	}
+}
+
+// score and lives straight from the atlas, no texture per frame
+static void DrawBakedScore(SDL_Renderer* renderer, GameLabels* labels, const UIFont& font, const GameState& state) {
+	char score[16];
+	char lives[16];
+	snprintf(score, sizeof(score), "%d", state.score);
+	snprintf(lives, sizeof(lives), "%d", state.lives);
+
+	int livesWidth = MeasureBakedText(*font.face, lives);
+	labels->livesLabel.rect.x = GAME_WIDTH - labels->livesLabel.rect.w - livesWidth;
+
+	SDL_RenderCopy(renderer, labels->scoreLabel.texture, NULL, &labels->scoreLabel.rect);
+	SDL_RenderCopy(renderer, labels->livesLabel.texture, NULL, &labels->livesLabel.rect);
+	gRenderStats.drawCalls += 2;
+	DrawBakedText(renderer, *font.baked, *font.face, score, labels->scoreLabel.rect.x + labels->scoreLabel.rect.w, labels->scoreLabel.rect.y);
+	DrawBakedText(renderer, *font.baked, *font.face, lives, GAME_WIDTH - livesWidth, labels->livesLabel.rect.y);
+}
+
+static TextLabel CreateUITextLabel(SDL_Renderer* renderer, const UIFont& font, const char* text) {
+	SDL_Surface* surface = RenderUIText(font, text);
+	TextLabel label = CreateTextLabelFromSurface(renderer, surface);
+	SDL_FreeSurface(surface);
+	return label;
+}
+
+// a texture per frame for the numbers, when the atlas could not be uploaded (the baked glyphs are still used
+// if they loaded, otherwise the TTF font)
+static void DrawScore(SDL_Renderer* renderer, GameLabels* labels, const UIFont& font, const GameState& state) {
+	TextLabel score = CreateUITextLabel(renderer, font, std::to_string(state.score).c_str());
+	TextLabel lives = CreateUITextLabel(renderer, font, std::to_string(state.lives).c_str());
+
+	score.rect.x = labels->scoreLabel.rect.x + labels->scoreLabel.rect.w;
+	lives.rect.x = GAME_WIDTH - lives.rect.w;
+	labels->livesLabel.rect.x = GAME_WIDTH - labels->livesLabel.rect.w - lives.rect.w;
+
+	SDL_RenderCopy(renderer, labels->scoreLabel.texture, NULL, &labels->scoreLabel.rect);
+	SDL_RenderCopy(renderer, labels->livesLabel.texture, NULL, &labels->livesLabel.rect);
+	SDL_RenderCopy(renderer, score.texture, NULL, &score.rect);
+	SDL_RenderCopy(renderer, lives.texture, NULL, &lives.rect);
+	gRenderStats.drawCalls += 4;
+
+	// destroy on every frame the score and lives textures ~~ may be bad for performance
+	// but should at least solve memory leak issue
+	DestroyTextLabel(&score);
+	DestroyTextLabel(&lives);
+}
+
+void DrawUI(SDL_Renderer* renderer, GameLabels* labels, const UIFont& font, const GameState& state) {
+	if (state.isGameOver) {
+		SDL_RenderCopy(renderer, labels->gameOver.texture, NULL, &labels->gameOver.rect);
+		SDL_RenderCopy(renderer, labels->playAgain.texture, NULL, &labels->playAgain.rect);
+		gRenderStats.drawCalls += 2;
+	}
+
+	if (state.isGamePaused) {
+		SDL_RenderCopy(renderer, labels->gamePause.texture, NULL, &labels->gamePause.rect);
+		SDL_RenderCopy(renderer, labels->pauseLabel.texture, NULL, &labels->pauseLabel.rect);
+		gRenderStats.drawCalls += 2;
+	}
+
+	if (font.baked != NULL && font.baked->texture != NULL) {
+		DrawBakedScore(renderer, labels, font, state);
+	}
+	else {
+		DrawScore(renderer, labels, font, state);
+	}
+}
+
+// power-ups in their colors, one fill call per kind
+static void DrawEntities(SDL_Renderer* renderer, const EntityPool& entities) {
+	for (int kind = 0; kind <= (int)EntityKind::LASER_SHOT; ++kind) {
+		SDL_Rect rects[MAX_ENTITIES];
+		int count = 0;
+		for (int i = 0; i < entities.count; ++i) {
+			if ((int)entities.kinds[i] == kind) {
+				rects[count++] = GetEntityRect(entities, i);
+			}
+		}
+		if (count == 0) {
+			continue;
+		}
+
+		SDL_Color color = kind < POWER_UP_KIND_COUNT ? POWER_UP_COLORS[kind] : TEXT_COLOR;
+		SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+		SDL_RenderFillRects(renderer, rects, count);
+		++gRenderStats.drawCalls;
+	}
+}
+
+void DrawGame(SDL_Renderer* renderer, const GameState& state) {
+	drawBricks(renderer, state.bricks, state.brickStates, BRICKS_COUNT);
+	if (state.entities.count > 0) {
+		DrawEntities(renderer, state.entities);
+	}
+
+	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+	SDL_RenderFillRect(renderer, &state.paddle);
+	SDL_RenderFillRect(renderer, &state.ball);
+	gRenderStats.drawCalls += 2;
+	if (state.extraBallCount > 0) {
+		SDL_RenderFillRects(renderer, state.extraBalls, state.extraBallCount);
+		++gRenderStats.drawCalls;
+	}
+}
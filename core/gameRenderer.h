@@ -0,0 +1,96 @@
+#ifndef GAME_RENDERER_H
+#define GAME_RENDERER_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "bakedFont.h"
+#include "game.h"
+
+// Text rasterized once into a texture
+struct TextLabel {
+	SDL_Texture* texture;
+	SDL_Rect rect;
+};
+
+// Static text shown by the UI, the prompts differ between platforms
+struct GameLabels {
+	TextLabel scoreLabel;
+	TextLabel livesLabel;
+	TextLabel gameOver;
+	TextLabel playAgain;
+	TextLabel gamePause;
+	TextLabel pauseLabel;
+};
+
+// The labels above rendered by SDL_ttf but not uploaded yet, so they can be prepared on another thread
+struct GameLabelSurfaces {
+	SDL_Surface* scoreLabel;
+	SDL_Surface* livesLabel;
+	SDL_Surface* gameOver;
+	SDL_Surface* playAgain;
+	SDL_Surface* gamePause;
+	SDL_Surface* pauseLabel;
+};
+
+// TTF font opened the first time a string has characters that were not baked, so FreeType is only started
+// when it is needed. Opened by whichever thread renders the text (the asset loader's for the labels)
+struct TTFFallback {
+	TTF_Font* (*open)(void* context, const char* name, int size);
+	void* context;
+	const char* name;
+	int size;
+	TTF_Font* font; // NULL until needed, and if it could not be opened
+	bool isOpened; // tried already
+};
+
+// Font of the UI text: glyphs baked offline (see bakedFont.h) with SDL_ttf as the fallback for text that was not baked.
+// Any of them may be NULL, without a TTF font missing characters are drawn as '?'
+struct UIFont {
+	TTF_Font* ttf;
+	const BakedFont* baked;
+	const BakedFace* face; // size of the baked font to use
+	TTFFallback* fallback; // opens the TTF font on demand when ttf is NULL
+};
+
+const SDL_Color TEXT_COLOR { 255, 255, 255, 255 };
+
+// Renderer calls made by the functions below, the frame loop resets it at the start of every frame
+struct RenderStats {
+	Uint32 drawCalls;
+	Uint32 textureCreations;
+};
+
+extern RenderStats gRenderStats;
+
+TextLabel CreateTextLabelFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
+
+TextLabel CreateTextLabel(SDL_Renderer* renderer, TTF_Font* font, const char* text);
+
+// Like TTF_RenderText_Solid, from the baked glyphs if there are all of them. Can be called from any thread
+SDL_Surface* RenderUIText(const UIFont& font, const char* text);
+
+void DestroyTextLabel(TextLabel* label);
+
+// Does not need a renderer, safe to call from a loader thread
+void RenderGameLabelSurfaces(GameLabelSurfaces* surfaces, const UIFont& font, const UIFont& bigFont, const char* playAgainText, const char* unpauseText);
+
+void FreeGameLabelSurfaces(GameLabelSurfaces* surfaces);
+
+// Uploads the surfaces (render thread only) and frees them
+void CreateGameLabelsFromSurfaces(SDL_Renderer* renderer, GameLabels* labels, GameLabelSurfaces* surfaces);
+
+void CreateGameLabels(SDL_Renderer* renderer, GameLabels* labels, TTF_Font* font, TTF_Font* bigFont, const char* playAgainText, const char* unpauseText);
+
+void DestroyGameLabels(GameLabels* labels);
+
+// Standing bricks in their palette colors (see GetBrickPalette()), one fill call per color
+void drawBricks(SDL_Renderer* renderer, const SDL_Rect* bricks, const BrickState* brickStates, int bricksCount);
+
+// Draws score, lives and the game over/pause overlays
+void DrawUI(SDL_Renderer* renderer, GameLabels* labels, const UIFont& font, const GameState& state);
+
+// Draws bricks, power-ups, paddle and balls
+void DrawGame(SDL_Renderer* renderer, const GameState& state);
+
+#endif
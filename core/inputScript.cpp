@@ -0,0 +1,58 @@
+#include "inputScript.h"
+
+#include <string.h>
+
+static const char* SESSION_HEADER = "breakout-session 1";
+
+bool LoadInputScript(const char* path, InputScript* script) {
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		return false;
+	}
+
+	char line[128];
+	if (fgets(line, sizeof(line), file) == NULL || strncmp(line, SESSION_HEADER, strlen(SESSION_HEADER)) != 0 ||
+		fscanf(file, " seed %u", &script->seed) != 1) {
+		fclose(file);
+		return false;
+	}
+
+	script->frames.clear();
+	RecordedFrame frame;
+	int togglePause;
+	int restart;
+	while (fscanf(file, "%f %f %d %d", &frame.timeDelta, &frame.input.paddleTravel, &togglePause, &restart) == 4) {
+		frame.input.togglePause = togglePause != 0;
+		frame.input.restart = restart != 0;
+		script->frames.push_back(frame);
+	}
+
+	fclose(file);
+	return true;
+}
+
+bool BeginRecording(InputRecorder* recorder, const char* path, unsigned int seed) {
+	recorder->file = fopen(path, "w");
+	if (recorder->file == NULL) {
+		return false;
+	}
+
+	fprintf(recorder->file, "%s\nseed %u\n", SESSION_HEADER, seed);
+	return true;
+}
+
+void RecordFrame(InputRecorder* recorder, float timeDelta, const GameInput& input) {
+	if (recorder->file == NULL) {
+		return;
+	}
+
+	// %.9g round trips a float exactly
+	fprintf(recorder->file, "%.9g %.9g %d %d\n", timeDelta, input.paddleTravel, input.togglePause ? 1 : 0, input.restart ? 1 : 0);
+}
+
+void EndRecording(InputRecorder* recorder) {
+	if (recorder->file != NULL) {
+		fclose(recorder->file);
+		recorder->file = NULL;
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "game.h"
+
+// Recorded sessions store the seed a game was started with plus the time step and GameInput of
+// every frame, so the session can be replayed through the frame loop deterministically.
+//
+// File format (text, one frame per line after the header):
+//   breakout-session 1
+//   seed <seed>
+//   <timeDelta> <paddleTravel> <togglePause> <restart>
+struct RecordedFrame {
+	float timeDelta;
+	GameInput input;
+};
+
+struct InputScript {
+	unsigned int seed;
+	std::vector<RecordedFrame> frames;
+};
+
+// returns false if the file could not be opened or is not a session file
+bool LoadInputScript(const char* path, InputScript* script);
+
+// Writes frames to a session file while the game is being played
+struct InputRecorder {
+	FILE* file;
+};
+
+bool BeginRecording(InputRecorder* recorder, const char* path, unsigned int seed);
+
+void RecordFrame(InputRecorder* recorder, float timeDelta, const GameInput& input);
+
+void EndRecording(InputRecorder* recorder);
+
+#endif
@@ -0,0 +1,39 @@
+#include "latencyProbe.h"
+
+void InitLatencyProbe(LatencyProbe* probe, bool isEnabled) {
+	*probe = LatencyProbe{ isEnabled, false, 0, 0, 0, 0, 0 };
+}
+
+void RecordInputEvent(LatencyProbe* probe, Uint64 timestamp) {
+	if (probe->isEnabled && !probe->isPending) {
+		probe->isPending = true;
+		probe->eventTimestamp = timestamp;
+	}
+}
+
+void RecordPresent(LatencyProbe* probe, Uint64 presentedAt) {
+	if (!probe->isEnabled || !probe->isPending) {
+		return;
+	}
+
+	Uint64 latency = presentedAt > probe->eventTimestamp ? presentedAt - probe->eventTimestamp : 0;
+	probe->isPending = false;
+	probe->totalMicros += latency;
+	probe->minMicros = (probe->samples == 0 || latency < probe->minMicros) ? latency : probe->minMicros;
+	probe->maxMicros = latency > probe->maxMicros ? latency : probe->maxMicros;
+	++probe->samples;
+
+	SDL_Log("input to present latency: %.2f ms", latency / 1000.0f);
+	if (probe->samples % LATENCY_REPORT_INTERVAL == 0) {
+		SDL_Log("input to present latency over %u samples: min %.2f ms, avg %.2f ms, max %.2f ms",
+			(unsigned int)probe->samples, probe->minMicros / 1000.0f,
+			probe->totalMicros / 1000.0f / probe->samples, probe->maxMicros / 1000.0f);
+	}
+}
+
+void DrawLatencyFlash(SDL_Renderer* renderer, const LatencyProbe& probe) {
+	if (probe.isPending) {
+		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+		SDL_RenderFillRect(renderer, &LATENCY_FLASH_RECT);
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <SDL.h>
+
+// Input-to-photon latency measurement mode
+// Every input flashes a white square in the top left corner of the screen for the frame that responds to it,
+// so the value logged here (input timestamp -> SDL_RenderPresent returned) can be checked against a
+// photodiode or a high speed camera pointed at that corner.
+// All times are measured in microseconds and must come from the same clock
+struct LatencyProbe {
+	bool isEnabled;
+	bool isPending;
+	Uint64 eventTimestamp;
+	Uint32 samples;
+	Uint64 totalMicros;
+	Uint64 minMicros;
+	Uint64 maxMicros;
+};
+
+const int LATENCY_REPORT_INTERVAL = 20;
+const SDL_Rect LATENCY_FLASH_RECT { 0, 0, 40, 40 };
+
+void InitLatencyProbe(LatencyProbe* probe, bool isEnabled);
+
+void RecordInputEvent(LatencyProbe* probe, Uint64 timestamp);
+
+void RecordPresent(LatencyProbe* probe, Uint64 presentedAt);
+
+// Draws the flash square while an input is waiting to be presented
+void DrawLatencyFlash(SDL_Renderer* renderer, const LatencyProbe& probe);
+
+#endif
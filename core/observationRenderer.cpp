@@ -0,0 +1,202 @@
+#include "observationRenderer.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+// luma of a color, 0 to 255
+static float GetLuma(const SDL_Color& color) {
+	return 0.299f * color.r + 0.587f * color.g + 0.114f * color.b;
+}
+
+// Adds value times the part of every output pixel the rectangle covers. Coverage is separable for
+// rectangles, so the column weights are worked out once and every row is a single multiply-add
+// over consecutive pixels the compiler can vectorize
+static void AddRect(const SDL_Rect& rect, float value, int width, int height, float* scratch) {
+	int x0 = SDL_max(rect.x, 0);
+	int y0 = SDL_max(rect.y, 0);
+	int x1 = SDL_min(rect.x + rect.w, GAME_WIDTH);
+	int y1 = SDL_min(rect.y + rect.h, GAME_HEIGHT);
+	if (x1 <= x0 || y1 <= y0) {
+		return;
+	}
+
+	// in output pixels
+	float left = x0 * width / (float)GAME_WIDTH;
+	float right = x1 * width / (float)GAME_WIDTH;
+	float top = y0 * height / (float)GAME_HEIGHT;
+	float bottom = y1 * height / (float)GAME_HEIGHT;
+	int firstColumn = (int)left;
+	int lastColumn = SDL_min((int)ceilf(right), width) - 1;
+	int firstRow = (int)top;
+	int lastRow = SDL_min((int)ceilf(bottom), height) - 1;
+
+	float columnCoverage[GAME_WIDTH];
+	int columnCount = lastColumn - firstColumn + 1;
+	for (int i = 0; i < columnCount; ++i) {
+		int column = firstColumn + i;
+		columnCoverage[i] = SDL_min(right, column + 1.0f) - SDL_max(left, (float)column);
+	}
+
+	for (int row = firstRow; row <= lastRow; ++row) {
+		float rowValue = value * (SDL_min(bottom, row + 1.0f) - SDL_max(top, (float)row));
+		float* pixel = scratch + row * width + firstColumn;
+		for (int i = 0; i < columnCount; ++i) {
+			pixel[i] += rowValue * columnCoverage[i];
+		}
+	}
+}
+
+void RenderObservation(const GameState& state, int width, int height, float* scratch, Uint8* pixels) {
+	int pixelCount = width * height;
+	std::fill(scratch, scratch + pixelCount, 0.0f);
+
+	const SDL_Color* palette = GetBrickPalette();
+	for (int i = 0; i < BRICKS_COUNT; ++i) {
+		BrickState brick = state.brickStates[i];
+		if (GetBrickHitPoints(brick) != 0) {
+			AddRect(state.bricks[i], GetLuma(palette[brick]), width, height, scratch);
+		}
+	}
+	for (int i = 0; i < state.entities.count; ++i) {
+		EntityKind kind = state.entities.kinds[i];
+		float luma = kind == EntityKind::LASER_SHOT ? 255.0f : GetLuma(POWER_UP_COLORS[(int)kind]);
+		AddRect(GetEntityRect(state.entities, i), luma, width, height, scratch);
+	}
+	AddRect(state.paddle, 255.0f, width, height, scratch);
+	AddRect(state.ball, 255.0f, width, height, scratch);
+	for (int i = 0; i < state.extraBallCount; ++i) {
+		AddRect(state.extraBalls[i], 255.0f, width, height, scratch);
+	}
+
+	for (int i = 0; i < pixelCount; ++i) {
+		pixels[i] = (Uint8)SDL_min(scratch[i] + 0.5f, 255.0f);
+	}
+}
+
+struct ObservationWorkers {
+	std::vector<std::thread> threads; // thread t renders share t + 1
+	std::vector<std::vector<float>> scratch; // per share, the calling thread's first
+	std::mutex mutex;
+	std::condition_variable batchReady;
+	std::condition_variable batchDone;
+	// the batch being rendered, written under the mutex
+	const GameState* states;
+	int count;
+	int width;
+	int height;
+	Uint8* pixels;
+	int shares;
+	Uint32 batch; // counts the batches, a new value wakes the workers
+	int pendingShares; // not rendered by the workers yet
+	bool isStopping;
+};
+
+// share of a batch split into shares parts, scratch grows to the image size once
+static void RenderShare(ObservationWorkers* workers, int share) {
+	int first = workers->count * share / workers->shares;
+	int last = workers->count * (share + 1) / workers->shares;
+	size_t pixelCount = (size_t)workers->width * workers->height;
+	std::vector<float>& scratch = workers->scratch[share];
+	if (scratch.size() < pixelCount) {
+		scratch.resize(pixelCount);
+	}
+	for (int i = first; i < last; ++i) {
+		RenderObservation(workers->states[i], workers->width, workers->height, scratch.data(), workers->pixels + i * pixelCount);
+	}
+}
+
+static void RunWorker(ObservationWorkers* workers, int share) {
+	Uint32 batch = 0;
+	std::unique_lock<std::mutex> lock(workers->mutex);
+	while (true) {
+		workers->batchReady.wait(lock, [&] { return workers->isStopping || workers->batch != batch; });
+		if (workers->isStopping) {
+			return;
+		}
+		batch = workers->batch;
+		if (share >= workers->shares) {
+			continue;
+		}
+
+		lock.unlock();
+		RenderShare(workers, share);
+		lock.lock();
+		if (--workers->pendingShares == 0) {
+			workers->batchDone.notify_one();
+		}
+	}
+}
+
+ObservationWorkers* CreateObservationWorkers(int maxThreadCount) {
+	ObservationWorkers* workers = new (std::nothrow) ObservationWorkers();
+	if (workers == NULL) {
+		return NULL;
+	}
+	workers->count = 0;
+	workers->width = 0;
+	workers->height = 0;
+	workers->pixels = NULL;
+	workers->shares = 0;
+	workers->batch = 0;
+	workers->pendingShares = 0;
+	workers->isStopping = false;
+
+	int threadCount = SDL_max(1, maxThreadCount);
+	workers->scratch.resize(threadCount);
+	try {
+		for (int share = 1; share < threadCount; ++share) {
+			workers->threads.emplace_back(RunWorker, workers, share);
+		}
+	}
+	catch (const std::exception&) {
+		DestroyObservationWorkers(workers);
+		return NULL;
+	}
+	return workers;
+}
+
+void DestroyObservationWorkers(ObservationWorkers* workers) {
+	if (workers == NULL) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(workers->mutex);
+		workers->isStopping = true;
+	}
+	workers->batchReady.notify_all();
+	for (size_t t = 0; t < workers->threads.size(); ++t) {
+		workers->threads[t].join();
+	}
+	delete workers;
+}
+
+void RenderObservations(ObservationWorkers* workers, const GameState* states, int count, int width, int height, Uint8* pixels, int threadCount) {
+	int shares = SDL_max(1, SDL_min(SDL_min(threadCount, count), (int)workers->scratch.size()));
+	{
+		std::lock_guard<std::mutex> lock(workers->mutex);
+		workers->states = states;
+		workers->count = count;
+		workers->width = width;
+		workers->height = height;
+		workers->pixels = pixels;
+		workers->shares = shares;
+		workers->pendingShares = shares - 1;
+		++workers->batch;
+	}
+	if (shares > 1) {
+		workers->batchReady.notify_all();
+	}
+
+	// the calling thread renders the first share
+	RenderShare(workers, 0);
+	if (shares > 1) {
+		std::unique_lock<std::mutex> lock(workers->mutex);
+		workers->batchDone.wait(lock, [&] { return workers->pendingShares == 0; });
+	}
+}
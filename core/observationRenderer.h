@@ -0,0 +1,33 @@
+#ifndef OBSERVATION_RENDERER_H
+#define OBSERVATION_RENDERER_H
+
+#include "game.h"
+
+// Draws downscaled grayscale images of games on the CPU, straight from the game state without SDL.
+// Every rectangle is drawn with its exact area coverage of the output pixels, which is what rendering
+// the full GAME_WIDTH x GAME_HEIGHT frame and box filtering it would give, at a fraction of the cost.
+// Bricks and power-ups are drawn with the luma of their colors (see GetBrickPalette()), the paddle, the balls and
+// laser shots white.
+
+// width and height are at most GAME_WIDTH and GAME_HEIGHT
+inline bool IsValidObservationSize(int width, int height) {
+	return width > 0 && height > 0 && width <= GAME_WIDTH && height <= GAME_HEIGHT;
+}
+
+// pixels holds width * height bytes, rows from the top. scratch holds width * height floats
+void RenderObservation(const GameState& state, int width, int height, float* scratch, Uint8* pixels);
+
+// Threads kept for RenderObservations() with a scratch image each, so rendering a batch neither starts threads
+// nor allocates (unless the images are larger than any rendered before). The workers sleep between batches
+struct ObservationWorkers;
+
+// maxThreadCount - 1 workers, the calling thread renders a share too. NULL if the threads could not be started
+ObservationWorkers* CreateObservationWorkers(int maxThreadCount);
+
+void DestroyObservationWorkers(ObservationWorkers* workers);
+
+// Renders count games into consecutive images, split between threadCount threads (at most the workers'
+// maxThreadCount, 1 renders on the calling thread). Not to be called from two threads at once
+void RenderObservations(ObservationWorkers* workers, const GameState* states, int count, int width, int height, Uint8* pixels, int threadCount);
+
+#endif
@@ -0,0 +1,103 @@
+#include "powerUps.h"
+
+#include <string.h>
+
+void ClearEntities(EntityPool* pool) {
+	// the catch test reads the whole pool
+	memset(pool, 0, sizeof(*pool));
+}
+
+bool SpawnEntity(EntityPool* pool, EntityKind kind, int x, int y) {
+	if (pool->count == MAX_ENTITIES) {
+		return false;
+	}
+
+	pool->x[pool->count] = x;
+	pool->y[pool->count] = (float)y;
+	pool->kinds[pool->count] = kind;
+	++pool->count;
+	return true;
+}
+
+SDL_Rect GetEntityRect(const EntityPool& pool, int index) {
+	if (pool.kinds[index] == EntityKind::LASER_SHOT) {
+		return SDL_Rect{ pool.x[index], (int)pool.y[index], LASER_SHOT_WIDTH, LASER_SHOT_HEIGHT };
+	}
+	return SDL_Rect{ pool.x[index], (int)pool.y[index], POWER_UP_WIDTH, POWER_UP_HEIGHT };
+}
+
+Uint32 FindCaughtPowerUps(const EntityPool& pool, const SDL_Rect& paddle) {
+	// all bits set for a caught one
+	Uint32 caught[MAX_ENTITIES];
+	for (int i = 0; i < MAX_ENTITIES; ++i) {
+		int top = (int)pool.y[i];
+		caught[i] = 0u - ((i < pool.count) & (pool.kinds[i] != EntityKind::LASER_SHOT) &
+			(pool.x[i] < paddle.x + paddle.w) & (pool.x[i] + POWER_UP_WIDTH > paddle.x) &
+			(top < paddle.y + paddle.h) & (top + POWER_UP_HEIGHT > paddle.y));
+	}
+
+	// a table rather than 1 << i, shifting every lane by a different amount does not vectorize everywhere
+	static const Uint32 ENTITY_BITS[MAX_ENTITIES] = {
+		1u << 0, 1u << 1, 1u << 2, 1u << 3, 1u << 4, 1u << 5, 1u << 6, 1u << 7,
+		1u << 8, 1u << 9, 1u << 10, 1u << 11, 1u << 12, 1u << 13, 1u << 14, 1u << 15
+	};
+	Uint32 mask = 0;
+	for (int i = 0; i < MAX_ENTITIES; ++i) {
+		mask |= caught[i] & ENTITY_BITS[i];
+	}
+	return mask;
+}
+
+void RemoveEntities(EntityPool* pool, Uint32 removed) {
+	// from the back, so the entity moved into a place was looked at already
+	for (int i = pool->count - 1; i >= 0; --i) {
+		if ((removed >> i) & 1) {
+			--pool->count;
+			pool->x[i] = pool->x[pool->count];
+			pool->y[i] = pool->y[pool->count];
+			pool->kinds[i] = pool->kinds[pool->count];
+		}
+	}
+}
+
+void ClearEffectWheel(EffectWheel* wheel) {
+	memset(wheel, 0, sizeof(*wheel));
+}
+
+void ScheduleEvent(EffectWheel* wheel, TimerEvent event, int ticks) {
+	CancelEvent(wheel, event);
+	int slot = (wheel->tick + ticks) % EFFECT_WHEEL_SLOTS;
+	wheel->slots[slot] |= 1 << (int)event;
+	wheel->eventSlots[(int)event] = (Uint8)slot;
+	wheel->pendingEvents |= 1 << (int)event;
+}
+
+void CancelEvent(EffectWheel* wheel, TimerEvent event) {
+	if (IsEventPending(*wheel, event)) {
+		wheel->slots[wheel->eventSlots[(int)event]] &= ~(1 << (int)event);
+		wheel->pendingEvents &= ~(1 << (int)event);
+	}
+}
+
+Uint32 AdvanceEffectWheel(EffectWheel* wheel, float timeDelta) {
+	if (wheel->pendingEvents == 0) {
+		return 0;
+	}
+
+	const float TICK_SECONDS = EFFECT_TICK_MILLIS / 1000.0f;
+	Uint32 dueEvents = 0;
+	wheel->tickRemainder += timeDelta;
+	while (wheel->tickRemainder >= TICK_SECONDS && wheel->pendingEvents != 0) {
+		wheel->tickRemainder -= TICK_SECONDS;
+		++wheel->tick;
+		Uint8& slot = wheel->slots[wheel->tick % EFFECT_WHEEL_SLOTS];
+		dueEvents |= slot;
+		wheel->pendingEvents &= ~slot;
+		slot = 0;
+	}
+	// time only counts while something is pending
+	if (wheel->pendingEvents == 0) {
+		wheel->tickRemainder = 0.0f;
+	}
+	return dueEvents;
+}
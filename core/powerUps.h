@@ -0,0 +1,98 @@
+#ifndef POWER_UPS_H
+#define POWER_UPS_H
+
+// Power-ups falling from destroyed bricks and the laser shots of the laser power-up, and the timers of the
+// effects they give. StepGame() drives them, this only knows about rectangles and time.
+#include <SDL_rect.h>
+#include <SDL_pixels.h>
+
+enum class EntityKind : Uint8 {
+	// power-ups, caught with the paddle
+	WIDE_PADDLE = 0,
+	SLOW_BALL,
+	MULTI_BALL,
+	LASER,
+	// shot upwards by the paddle while the laser is on
+	LASER_SHOT
+};
+
+const int POWER_UP_KIND_COUNT = 4;
+const SDL_Color POWER_UP_COLORS[POWER_UP_KIND_COUNT] {
+	{ 0, 200, 0, 255 },
+	{ 0, 128, 255, 255 },
+	{ 255, 215, 0, 255 },
+	{ 255, 40, 40, 255 }
+};
+
+const int POWER_UP_WIDTH = 30;
+const int POWER_UP_HEIGHT = 14;
+const int POWER_UP_FALL_SPEED = 150;
+const int LASER_SHOT_WIDTH = 4;
+const int LASER_SHOT_HEIGHT = 12;
+const int LASER_SHOT_SPEED = 600;
+
+// falling power-ups and laser shots at once, more are not spawned
+const int MAX_ENTITIES = 16;
+
+// Structure of arrays, so a test runs over the same field of every entity at once.
+// The live entities are packed at the front, the rest keep whatever was there
+struct EntityPool {
+	int x[MAX_ENTITIES];
+	float y[MAX_ENTITIES];
+	EntityKind kinds[MAX_ENTITIES];
+	int count;
+};
+
+void ClearEntities(EntityPool* pool);
+
+// false if the pool is full
+bool SpawnEntity(EntityPool* pool, EntityKind kind, int x, int y);
+
+SDL_Rect GetEntityRect(const EntityPool& pool, int index);
+
+// Bit i set for every power-up overlapping the paddle. The test of canRectanglesOverlap() without branches,
+// over the whole pool in one pass the compiler can vectorize
+Uint32 FindCaughtPowerUps(const EntityPool& pool, const SDL_Rect& paddle);
+
+// Removes the entities of the bits set, moving the last ones into their places
+void RemoveEntities(EntityPool* pool, Uint32 removed);
+
+// Events of the timed effects
+enum class TimerEvent : Uint8 {
+	WIDE_PADDLE_ENDS = 0,
+	SLOW_BALL_ENDS,
+	LASER_ENDS,
+	LASER_FIRES,
+};
+
+const int TIMER_EVENT_COUNT = 4;
+
+const int EFFECT_TICK_MILLIS = 50;
+// one revolution is 12.8 s, events are scheduled at most that far ahead
+const int EFFECT_WHEEL_SLOTS = 256;
+
+// Timer wheel: every slot holds the events due at its tick as a bitmask, so advancing time only looks at the
+// slots passed, and nothing at all while no event is pending. A kind of event is pending at most once
+struct EffectWheel {
+	Uint8 slots[EFFECT_WHEEL_SLOTS];
+	Uint8 eventSlots[TIMER_EVENT_COUNT]; // slot of every pending event
+	Uint8 pendingEvents; // bit per TimerEvent
+	Uint32 tick;
+	float tickRemainder; // seconds towards the next tick
+};
+
+void ClearEffectWheel(EffectWheel* wheel);
+
+inline bool IsEventPending(const EffectWheel& wheel, TimerEvent event) {
+	return (wheel.pendingEvents >> (int)event) & 1;
+}
+
+// Due in ticks (1 to EFFECT_WHEEL_SLOTS - 1) from now, replaces the pending one of the same kind
+void ScheduleEvent(EffectWheel* wheel, TimerEvent event, int ticks);
+
+void CancelEvent(EffectWheel* wheel, TimerEvent event);
+
+// Moves time on by timeDelta seconds and returns the events that came due, a bit per TimerEvent
+Uint32 AdvanceEffectWheel(EffectWheel* wheel, float timeDelta);
+
+#endif
@@ -0,0 +1,80 @@
+#include "renderScaler.h"
+
+#include "game.h"
+#include "gameRenderer.h"
+
+static void DestroyTarget(RenderScaler* scaler) {
+	if (scaler->target != NULL) {
+		SDL_DestroyTexture(scaler->target);
+		scaler->target = NULL;
+	}
+	scaler->targetWidth = 0;
+	scaler->targetHeight = 0;
+}
+
+bool InitRenderScaler(RenderScaler* scaler, SDL_Renderer* renderer, float renderScale) {
+	*scaler = RenderScaler();
+	return UpdateRenderScaler(scaler, renderer, renderScale);
+}
+
+bool UpdateRenderScaler(RenderScaler* scaler, SDL_Renderer* renderer, float renderScale) {
+	scaler->renderScale = SDL_max(MIN_RENDER_SCALE, SDL_min(renderScale, 1.0f));
+	// the game area is letterboxed in the window, the target is copied into it the same way
+	if (SDL_GetRendererOutputSize(renderer, &scaler->outputWidth, &scaler->outputHeight) != 0 ||
+		SDL_RenderSetLogicalSize(renderer, GAME_WIDTH, GAME_HEIGHT) != 0) {
+		DestroyTarget(scaler);
+		return false;
+	}
+
+	if (scaler->renderScale == 1.0f || !SDL_RenderTargetSupported(renderer)) {
+		DestroyTarget(scaler);
+		return true;
+	}
+
+	// the letterboxed game area in window pixels, scaled down
+	float fit = SDL_min(scaler->outputWidth / (float)GAME_WIDTH, scaler->outputHeight / (float)GAME_HEIGHT) * scaler->renderScale;
+	int width = SDL_max(1, (int)(GAME_WIDTH * fit + 0.5f));
+	int height = SDL_max(1, (int)(GAME_HEIGHT * fit + 0.5f));
+	if (scaler->target != NULL && width == scaler->targetWidth && height == scaler->targetHeight) {
+		return true;
+	}
+
+	DestroyTarget(scaler);
+	scaler->target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	++gRenderStats.textureCreations;
+	if (scaler->target == NULL) {
+		return false;
+	}
+	SDL_SetTextureScaleMode(scaler->target, SDL_ScaleModeLinear);
+	scaler->targetWidth = width;
+	scaler->targetHeight = height;
+	return true;
+}
+
+void DestroyRenderScaler(RenderScaler* scaler) {
+	DestroyTarget(scaler);
+}
+
+void BeginScaledFrame(const RenderScaler& scaler, SDL_Renderer* renderer) {
+	if (scaler.target == NULL) {
+		return;
+	}
+
+	SDL_SetRenderTarget(renderer, scaler.target);
+	// switching to a target resets the scale, logical coordinates are mapped onto the target by hand
+	SDL_RenderSetScale(renderer, scaler.targetWidth / (float)GAME_WIDTH, scaler.targetHeight / (float)GAME_HEIGHT);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+}
+
+void EndScaledFrame(const RenderScaler& scaler, SDL_Renderer* renderer) {
+	if (scaler.target == NULL) {
+		return;
+	}
+
+	// back to the window and its logical size
+	SDL_SetRenderTarget(renderer, NULL);
+	const SDL_Rect gameArea{ 0, 0, GAME_WIDTH, GAME_HEIGHT };
+	SDL_RenderCopy(renderer, scaler.target, NULL, &gameArea);
+	++gRenderStats.drawCalls;
+}
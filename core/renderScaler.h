@@ -0,0 +1,40 @@
+#ifndef RENDER_SCALER_H
+#define RENDER_SCALER_H
+
+// Draws the game in its fixed GAME_WIDTH x GAME_HEIGHT logical space whatever size the window is in pixels
+// (resized, fullscreen or on a high-DPI display), letterboxed to keep the aspect ratio.
+// At a render scale of 1 every window pixel is drawn (SDL_RenderSetLogicalSize). Below 1 the frame is drawn
+// into a target texture that much smaller and stretched over the window with linear filtering: fewer pixels to
+// fill on weak hardware for a softer picture
+#include <SDL.h>
+
+const float MIN_RENDER_SCALE = 0.25f;
+
+struct RenderScaler {
+	// internal resolution relative to the window's pixels, MIN_RENDER_SCALE to 1
+	float renderScale;
+	// window size in pixels, larger than the window's size in points on high-DPI displays
+	int outputWidth;
+	int outputHeight;
+	// NULL while rendering straight to the window
+	SDL_Texture* target;
+	int targetWidth;
+	int targetHeight;
+};
+
+// False if SDL failed, the scaler then renders straight to the window
+bool InitRenderScaler(RenderScaler* scaler, SDL_Renderer* renderer, float renderScale);
+
+// Picks up a new window size or render scale, call it on SDL_WINDOWEVENT_SIZE_CHANGED
+bool UpdateRenderScaler(RenderScaler* scaler, SDL_Renderer* renderer, float renderScale);
+
+void DestroyRenderScaler(RenderScaler* scaler);
+
+// Everything drawn until EndScaledFrame() goes into the target, in logical coordinates. Clears the target
+void BeginScaledFrame(const RenderScaler& scaler, SDL_Renderer* renderer);
+
+// Stretches the target over the window, before SDL_RenderPresent(). Overlays drawn after it, in logical
+// coordinates, get the window's full resolution
+void EndScaledFrame(const RenderScaler& scaler, SDL_Renderer* renderer);
+
+#endif
@@ -12,6 +12,9 @@
 *    screen up to but not including the NUL character.
 *    Supports the most important CSI sequences of ECMA-48 / ISO/IEC 6429:1992.
 *    Graphic Rendition Combination Mode (GRCM) supported is Cumulative.
+*    Text is kept in a grid of cells and scrolls up when it reaches the bottom of the screen,
+*    only cells that changed since the last call are redrawn.
+*    (fonts with more cells than SCREEN_CONSOLE_MAX_COLS/ROWS wrap to the top instead)
 *    Modifications:
 *    - CSI SGR codes 30-37/38/39 & 40-47/48/49 set standard/fitting/default intensity, so instead of "\e[1;31m" use "\e31;1m"
 *    - ANSI color #8 is made darker (40<>80), so that "dark" white is still lighter than "bright" dark
@@ -58,9 +61,29 @@
 *               90–97   Set ANSI foreground color with increased intensity
 *               100–107 Set ANSI background color with increased intensity
 *
+* - psvDebugScreenPutsN()
+*    Like psvDebugScreenPuts() for length bytes of text, NUL bytes are drawn as glyph 0.
+*    Runs of text without "\e", "\n", "\r" and "\t" are found 8 bytes at a time and
+*    written to the console in bulk.
+*
 * - psvDebugScreenPrintf()
 *    Similar to the C library function printf() formats a string and ouputs
 *    it via psvDebugScreenPuts() to the debug screen.
+*    With asynchronous logging enabled it queues the string like psvDebugScreenLogPrintf() instead.
+*
+* - psvDebugScreenLogPrintf()
+*    Formats a string into a slot of a lock-free queue without touching the screen,
+*    can be called from any thread. Returns -1 if the queue is full and the message was dropped.
+*
+* - psvDebugScreenLogDrain(PsvDebugScreenLogWriter writer, void *context)
+*    Writes all queued messages in order via writer (or psvDebugScreenPuts() if NULL)
+*    and returns their number. Call from a single thread only, e.g. once per frame.
+*
+* - psvDebugScreenLogDropped()
+*    Number of messages dropped because the queue was full.
+*
+* - psvDebugScreenSetAsync(int enable)
+*    Enables or disables asynchronous logging for psvDebugScreenPrintf().
 *
 * - psvDebugScreenGetColorStateCopy(ColorState *copy)
 *    Get copy of current color state.
@@ -75,15 +98,29 @@
 *    Allows for multiple and custom position stores.
 *    Allows correct positioning when using different font sizes.
 *
+* - psvDebugScreenSetFramebuffer(void *framebuffer, int height)
+*    Draw into framebuffer (960 pixels per line, height lines) instead of the display,
+*    e.g. to upload the text as a texture. NULL switches back to the display.
+*    Text is laid out for the new height starting at the top left.
+*
+* - int psvDebugScreenGetDirtyRect(int *x, int *y, int *w, int *h)
+*    Get the pixels drawn since the previous call.
+*    Returns 0 if nothing was drawn.
+*
 * - PsvDebugScreenFont *psvDebugScreenGetFont()
 *    Get current font.
 *
 * - PsvDebugScreenFont *psvDebugScreenSetFont(PsvDebugScreenFont *font) {
 *    Set font. Returns current font.
+*    Also drops the glyphs cached for the previous font.
 *
 * - PsvDebugScreenFont *psvDebugScreenScaleFont2x(PsvDebugScreenFont *source_font) {
 *    Scales a font by 2 (e.g. 8x8 to 16x16) and returns new scaled font.
 *
+* - PsvDebugScreenFont *psvDebugScreenScaleFontNx(PsvDebugScreenFont *source_font, int scale) {
+*    Scales a font by 1-8 (e.g. 8x8 to 24x24 with 3) and returns new scaled font.
+*    Returns NULL if the scaled sizes do not fit (max. 255).
+*
 * Also see the following samples:
 * - debugscreen
 * - debug_print
@@ -106,13 +143,31 @@
 #define SCREEN_TAB_SIZE (8)
 #endif
 #define SCREEN_TAB_W    ((F)->size_w * (SCREEN_TAB_SIZE))
+#ifndef SCREEN_GLYPH_CACHE_SIZE // memory for expanded glyphs in bytes, 0 disables the cache
+#define SCREEN_GLYPH_CACHE_SIZE  (512 * 1024)
+#endif
+#ifndef SCREEN_GLYPH_CACHE_PAIRS // max. number of fg/bg color pairs cached at the same time
+#define SCREEN_GLYPH_CACHE_PAIRS (4)
+#endif
+#ifndef SCREEN_CONSOLE_MAX_COLS // text cells per line, enough for 8 pixel wide cells
+#define SCREEN_CONSOLE_MAX_COLS  ((SCREEN_WIDTH) / 8)
+#endif
+#ifndef SCREEN_CONSOLE_MAX_ROWS // text lines, enough for 8 pixel high cells
+#define SCREEN_CONSOLE_MAX_ROWS  ((SCREEN_HEIGHT) / 8)
+#endif
+#ifndef SCREEN_LOG_SLOTS // queued log messages, must be a power of 2
+#define SCREEN_LOG_SLOTS         (128)
+#endif
+#ifndef SCREEN_LOG_SLOT_SIZE // bytes per queued log message, longer messages are truncated
+#define SCREEN_LOG_SLOT_SIZE     (256)
+#endif
 #define F psvDebugScreenFontCurrent
 
 #define FROM_FULL_RGB(r,g,b ) ( ((b)<<16) | ((g)<<8) | (r) )
 #define CONVERT_RGB_BGR(rgb) rgb = ( (((rgb)&0x0000FF)<<16) | ((rgb)&0x00FF00) | (((rgb)&0xFF0000)>>16) )
 
-#define CLEARSCRNBLOCK(H,toH,W,toW,color) for (int h = (H); h < (toH); h++) for (int w = (W); w < (toW); w++) ((uint32_t*)base)[h*(SCREEN_FB_WIDTH) + w] = (color);
-#define CLEARSCRNLINES(H,toH,color) { uint32_t *pixel = (uint32_t *)base + ((H) * (SCREEN_FB_WIDTH)); int i = (((toH) - (H)) * (SCREEN_FB_WIDTH)); for (; i > 0; i--) *pixel++ = (color); }
+#define CLEARSCRNBLOCK(H,toH,W,toW,color) { psvDebugScreenTouch((W), (H), (toW) - (W), (toH) - (H)); for (int h = (H); h < (toH); h++) psvDebugScreenFill((uint32_t*)base + h*(SCREEN_FB_WIDTH) + (W), (toW) - (W), (color)); }
+#define CLEARSCRNLINES(H,toH,color) { psvDebugScreenTouch(0, (H), (SCREEN_WIDTH), (toH) - (H)); psvDebugScreenFill((uint32_t *)base + ((H) * (SCREEN_FB_WIDTH)), ((toH) - (H)) * (SCREEN_FB_WIDTH), (color)); }
 
 #define SAVE_STORAGES 16
 
@@ -132,6 +187,7 @@ static PsvDebugScreenFont *psvDebugScreenFontCurrent = &psvDebugScreenFont;
 #include <psp2/kernel/sysmem.h>
 #include <psp2/kernel/threadmgr.h>
 static void* base; // pointer to frame buffer
+static void* displayBase; // frame buffer shown on the display
 #else
 #define NO_psvDebugScreenInit
 #ifndef psvDebugScreenInitReplacement
@@ -139,8 +195,80 @@ static void* base; // pointer to frame buffer
 #endif
 #define sceKernelLockMutex(m,v,x) m=v
 #define sceKernelUnlockMutex(m,v) m=v
-static char base[(SCREEN_FB_WIDTH) * (SCREEN_HEIGHT) * 4];
+static char displayBuffer[(SCREEN_FB_WIDTH) * (SCREEN_HEIGHT) * 4];
+static void* base = displayBuffer;
+static void* displayBase = displayBuffer;
 #endif
+static int screenHeight = (SCREEN_HEIGHT); // lines of the frame buffer, less with psvDebugScreenSetFramebuffer()
+static int touchedX0, touchedY0, touchedX1, touchedY1; // pixels drawn since psvDebugScreenGetDirtyRect(), empty if x0 >= x1
+
+// glyph rows are expanded 4 pixels (one nibble of the bitmap) at a time,
+// nibblePixels holds all 16 nibble patterns in the colors glyphs are drawn with
+static uint32_t nibblePixels[16][4];
+static uint32_t drawColorFg, drawColorBg;
+
+// dotted line of the dummy glyph, 0x55 = bg/fg alternating and starting with bg
+static const unsigned char DUMMY_GLYPH_ROW[32] = { [0 ... 31] = 0x55 };
+
+// Glyphs of the current font fully expanded to pixels, one slot per fg/bg color pair.
+// Glyphs are expanded on first use, so drawing a cached glyph only copies its rows.
+// Slots are allocated on demand and the least recently selected one is reused
+// once SCREEN_GLYPH_CACHE_SIZE or SCREEN_GLYPH_CACHE_PAIRS is reached.
+typedef struct GlyphCacheSlot {
+	uint32_t color_fg;
+	uint32_t color_bg;
+	uint32_t *tiles; // width * height pixels per glyph, NULL if slot is unused
+	uint32_t lastUse;
+	uint32_t expanded[256 / 32]; // one bit per glyph
+} GlyphCacheSlot;
+
+static GlyphCacheSlot glyphCache[SCREEN_GLYPH_CACHE_PAIRS];
+static GlyphCacheSlot *glyphCacheCurrent; // slot for the current colors, NULL until selected
+static PsvDebugScreenFont *glyphCacheFont; // font the tiles were expanded from
+static int glyphCacheSlots; // slots that fit into SCREEN_GLYPH_CACHE_SIZE with this font
+static uint32_t glyphCacheUses;
+
+// Text console: the screen is a grid of cells in the size of the current font (size_w x size_h).
+// Rows are a ring buffer, so scrolling only moves consoleTop and clears the new bottom row.
+// consoleShadow holds what is in the framebuffer for each cell, Puts redraws the cells of
+// the touched (dirty) columns that differ from it.
+#define CELL_BLANK   (1) // cleared cell, only background
+#define CELL_UNKNOWN (2) // shadow only, framebuffer content is unknown
+
+typedef struct ConsoleCell {
+	uint32_t color_fg;
+	uint32_t color_bg;
+	unsigned char glyph;
+	unsigned char flags;
+	unsigned short unused; // no padding, so spans of cells can be compared with memcmp()
+} ConsoleCell;
+
+static ConsoleCell consoleCells[(SCREEN_CONSOLE_MAX_ROWS) * (SCREEN_CONSOLE_MAX_COLS)]; // by ring row
+static ConsoleCell consoleShadow[(SCREEN_CONSOLE_MAX_ROWS) * (SCREEN_CONSOLE_MAX_COLS)]; // by screen row
+static int dirtyFrom[SCREEN_CONSOLE_MAX_ROWS], dirtyTo[SCREEN_CONSOLE_MAX_ROWS]; // dirty columns of each screen row
+static int consoleCols, consoleRows; // 0 if the cells of the font do not fit, text then wraps to the top
+static int consoleTop; // ring row shown in the first screen row
+static PsvDebugScreenFont *consoleFont; // font the grid was laid out for
+
+// Log queue: bounded multi-producer single-consumer queue of formatted messages (after D. Vyukov's bounded queue).
+// Producers claim a position with a CAS and format straight into its slot, the sequence of a slot tells
+// whose turn it is. It is relative to the lap (position & ~(SCREEN_LOG_SLOTS-1)), so zeroed slots are free:
+//   sequence == lap                     free for the producer of that position
+//   sequence == lap + 1                 message ready for the consumer
+//   sequence == lap + SCREEN_LOG_SLOTS  consumed, free for the next lap
+#define LOG_LAP(position) ((position) & ~(uint32_t)((SCREEN_LOG_SLOTS) - 1))
+
+typedef struct LogSlot {
+	uint32_t sequence;
+	int length;
+	char text[SCREEN_LOG_SLOT_SIZE];
+} LogSlot;
+
+static LogSlot logSlots[SCREEN_LOG_SLOTS];
+static uint32_t logEnqueuePosition; // shared by the producers
+static uint32_t logDequeuePosition; // only used by the consumer
+static uint32_t logDropped;
+static int logAsync;
 
 static uint32_t DARK_COLORS_BGR[8] = {
 	0x000000, 0x000040, 0x004000, 0x004040, 0x400000, 0x400040, 0x404000, 0x808080, // 0-7
@@ -184,6 +312,311 @@ static uint32_t ANSI_COLORS_BGR[256] = {
 	0xa8a8a8, 0xb2b2b2, 0xbcbcbc, 0xc6c6c6, 0xd0d0d0, 0xdadada, 0xe4e4e4, 0xeeeeee, // 248-255
 };
 
+/*
+* Fill count pixels with color, 4 pixels per store
+*/
+static void psvDebugScreenFill(uint32_t *pixel, int count, uint32_t color) {
+	const uint32_t quad[4] = { color, color, color, color };
+	for (; count >= 4; count -= 4, pixel += 4)
+		memcpy(pixel, quad, sizeof(quad)); // fixed size copy, compiles to a single 128-bit store where available
+	for (; count > 0; count--)
+		*pixel++ = color;
+}
+
+/*
+* Copy count pixels, 4 pixels per load/store
+*/
+static void psvDebugScreenCopy(uint32_t *pixel, const uint32_t *source, int count) {
+	for (; count >= 4; count -= 4, pixel += 4, source += 4)
+		memcpy(pixel, source, 4 * sizeof(uint32_t));
+	for (; count > 0; count--)
+		*pixel++ = *source++;
+}
+
+/*
+* Add pixels to the rectangle reported by psvDebugScreenGetDirtyRect()
+*/
+static void psvDebugScreenTouch(int x, int y, int w, int h) {
+	if ((w <= 0) || (h <= 0)) return;
+	if (touchedX0 >= touchedX1) { // empty
+		touchedX0 = x; touchedY0 = y;
+		touchedX1 = x + w; touchedY1 = y + h;
+		return;
+	}
+	if (x < touchedX0) touchedX0 = x;
+	if (y < touchedY0) touchedY0 = y;
+	if (x + w > touchedX1) touchedX1 = x + w;
+	if (y + h > touchedY1) touchedY1 = y + h;
+}
+
+/*
+* Get count (1-8) glyph bits starting at bit offset, msb first
+*/
+static unsigned char psvDebugScreenGlyphBits(const unsigned char *glyphs, int offset, int count) {
+	const unsigned char *byte = glyphs + (offset / 8);
+	int shift = offset % 8;
+	unsigned int bits = byte[0] << shift;
+	if (shift + count > 8) bits |= byte[1] >> (8 - shift); // only touch the next byte if the bits continue there
+	return bits & (0xFF00 >> count);
+}
+
+/*
+* Draw width pixels of a glyph row, starting at bit offset of the bitmap
+* works also with not byte-aligned glyphs
+*/
+static void psvDebugScreenDrawGlyphRow(uint32_t *pixel, const unsigned char *glyphs, int offset, int width) {
+	uint32_t partial[8];
+	unsigned char bits;
+	for (; width >= 8; width -= 8, offset += 8, pixel += 8) {
+		bits = psvDebugScreenGlyphBits(glyphs, offset, 8);
+		memcpy(pixel, nibblePixels[bits >> 4], sizeof(nibblePixels[0]));
+		memcpy(pixel + 4, nibblePixels[bits & 0xF], sizeof(nibblePixels[0]));
+	}
+	if (width > 0) {
+		bits = psvDebugScreenGlyphBits(glyphs, offset, width);
+		memcpy(partial, nibblePixels[bits >> 4], sizeof(nibblePixels[0]));
+		memcpy(partial + 4, nibblePixels[bits & 0xF], sizeof(nibblePixels[0]));
+		memcpy(pixel, partial, width * sizeof(uint32_t));
+	}
+}
+
+/*
+* Set colors glyphs are drawn with and expand the nibble patterns in them
+*/
+static void psvDebugScreenSetDrawColors(uint32_t color_fg, uint32_t color_bg) {
+	if ((color_fg == drawColorFg) && (color_bg == drawColorBg)) return;
+	drawColorFg = color_fg;
+	drawColorBg = color_bg;
+	for (int nibble = 0; nibble < 16; nibble++)
+		for (int col = 0; col < 4; col++)
+			nibblePixels[nibble][col] = (nibble & (8 >> col)) ? color_fg : color_bg;
+	glyphCacheCurrent = NULL; // select the slot of the new colors on the next glyph
+}
+
+/*
+* Free all cached glyphs and size the cache for the current font
+*/
+static void psvDebugScreenInvalidateGlyphCache(void) {
+	size_t slotSize = (size_t)((F)->last - (F)->first + 1) * (F)->width * (F)->height * sizeof(uint32_t);
+	for (int i = 0; i < (SCREEN_GLYPH_CACHE_PAIRS); i++) {
+		free(glyphCache[i].tiles);
+		memset(&glyphCache[i], 0, sizeof(GlyphCacheSlot));
+	}
+	glyphCacheCurrent = NULL;
+	glyphCacheFont = F;
+	glyphCacheSlots = (slotSize && ((F)->last >= (F)->first)) ? (SCREEN_GLYPH_CACHE_SIZE) / slotSize : 0;
+	if (glyphCacheSlots > (SCREEN_GLYPH_CACHE_PAIRS)) glyphCacheSlots = (SCREEN_GLYPH_CACHE_PAIRS);
+}
+
+/*
+* Find the slot of the draw colors or reuse the least recently selected one
+*/
+static GlyphCacheSlot *psvDebugScreenSelectGlyphCacheSlot(void) {
+	GlyphCacheSlot *slot, *oldest = NULL;
+	if (glyphCacheFont != F) psvDebugScreenInvalidateGlyphCache();
+	for (int i = 0; i < glyphCacheSlots; i++) {
+		slot = &glyphCache[i];
+		if ((slot->tiles) && (slot->color_fg == drawColorFg) && (slot->color_bg == drawColorBg)) {
+			slot->lastUse = ++glyphCacheUses;
+			return slot;
+		}
+		if ((!oldest) || (oldest->tiles && ((!slot->tiles) || (slot->lastUse < oldest->lastUse)))) oldest = slot;
+	}
+	if (!oldest) return NULL; // a single color pair of this font does not fit
+	if (!oldest->tiles) {
+		oldest->tiles = (uint32_t *)malloc((size_t)((F)->last - (F)->first + 1) * (F)->width * (F)->height * sizeof(uint32_t));
+		if (!oldest->tiles) return NULL;
+	}
+	oldest->color_fg = drawColorFg;
+	oldest->color_bg = drawColorBg;
+	oldest->lastUse = ++glyphCacheUses;
+	memset(oldest->expanded, 0, sizeof(oldest->expanded));
+	return oldest;
+}
+
+/*
+* Return expanded pixels of a glyph in the current font and draw colors, NULL if it is not cached
+*/
+static const uint32_t *psvDebugScreenGetGlyphTile(unsigned char t) {
+	int glyph = t - (F)->first;
+	int tile_size = (F)->width * (F)->height;
+	uint32_t *tile;
+	if ((!glyphCacheCurrent) || (glyphCacheFont != F)) glyphCacheCurrent = psvDebugScreenSelectGlyphCacheSlot();
+	if (!glyphCacheCurrent) return NULL;
+	tile = glyphCacheCurrent->tiles + glyph * tile_size;
+	if (!(glyphCacheCurrent->expanded[glyph / 32] & (1u << (glyph % 32)))) {
+		for (int row = 0; row < (F)->height; row++)
+			psvDebugScreenDrawGlyphRow(tile + row * (F)->width, (F)->glyphs, (glyph * tile_size) + (row * (F)->width), (F)->width);
+		glyphCacheCurrent->expanded[glyph / 32] |= 1u << (glyph % 32);
+	}
+	return tile;
+}
+
+/*
+* Draw glyph or dummy glyph (dotted line in the middle) with its margins in the draw colors
+*/
+static void psvDebugScreenDrawGlyph(uint32_t *vram, unsigned char t) {
+	int bitmap_offset;
+	int row = 0;
+	int max_row;
+	const uint32_t *tile;
+
+	// rows are expanded from the bitmap, margins are filled with the background color
+	// check if glyph is available in font
+	if ((t > (F)->last) || (t < (F)->first)) {
+		// special case: dummy glyph, clear to middle height
+		max_row = (F)->height / 2;
+		for (; row < max_row; row++, vram += (SCREEN_FB_WIDTH))
+			psvDebugScreenFill(vram, (F)->size_w, drawColorBg);
+		if (row < (F)->height) {
+			psvDebugScreenDrawGlyphRow(vram, DUMMY_GLYPH_ROW, 0, (F)->width);
+			psvDebugScreenFill(vram + (F)->width, (F)->size_w - (F)->width, drawColorBg); // right margin
+			row++;
+			vram += (SCREEN_FB_WIDTH);
+		}
+	} else if ((tile = psvDebugScreenGetGlyphTile(t))) {
+		for (; row < (F)->height; row++, vram += (SCREEN_FB_WIDTH), tile += (F)->width) {
+			psvDebugScreenCopy(vram, tile, (F)->width);
+			psvDebugScreenFill(vram + (F)->width, (F)->size_w - (F)->width, drawColorBg); // right margin
+		}
+	} else { // not cached, expand rows directly
+		bitmap_offset = (t - (F)->first) * ((F)->width * (F)->height);
+		for (; row < (F)->height; row++, vram += (SCREEN_FB_WIDTH), bitmap_offset += (F)->width) {
+			psvDebugScreenDrawGlyphRow(vram, (F)->glyphs, bitmap_offset, (F)->width);
+			psvDebugScreenFill(vram + (F)->width, (F)->size_w - (F)->width, drawColorBg); // right margin
+		}
+	}
+	// draw bottom margin
+	for (; row < (F)->size_h; row++, vram += (SCREEN_FB_WIDTH))
+		psvDebugScreenFill(vram, (F)->size_w, drawColorBg);
+}
+
+/*
+* Cell in screen row/column
+*/
+static ConsoleCell *psvDebugScreenCell(int row, int col) {
+	return &consoleCells[(((consoleTop + row) % consoleRows) * (SCREEN_CONSOLE_MAX_COLS)) + col];
+}
+
+static void psvDebugScreenMarkDirty(int row, int from, int to) {
+	if (from < dirtyFrom[row]) dirtyFrom[row] = from;
+	if (to > dirtyTo[row]) dirtyTo[row] = to;
+}
+
+/*
+* Clear cells of a screen row to the current background color
+*/
+static void psvDebugScreenClearCells(int row, int from, int to) {
+	ConsoleCell *cell;
+	int col;
+	if ((row < 0) || (row >= consoleRows)) return;
+	if (from < 0) from = 0;
+	if (to > consoleCols) to = consoleCols;
+	if (from >= to) return;
+	for (col = from, cell = psvDebugScreenCell(row, from); col < to; col++, cell++) {
+		cell->color_fg = colors.color_fg;
+		cell->color_bg = colors.color_bg;
+		cell->glyph = ' ';
+		cell->flags = CELL_BLANK;
+		cell->unused = 0;
+	}
+	psvDebugScreenMarkDirty(row, from, to);
+}
+
+/*
+* Lay out the cell grid for the current font, the framebuffer content becomes unknown
+*/
+static void psvDebugScreenLayoutConsole(void) {
+	int row, col;
+	consoleFont = F;
+	consoleCols = ((F)->size_w) ? (SCREEN_WIDTH) / (F)->size_w : 0;
+	consoleRows = ((F)->size_h) ? screenHeight / (F)->size_h : 0;
+	if ((consoleCols > (SCREEN_CONSOLE_MAX_COLS)) || (consoleRows > (SCREEN_CONSOLE_MAX_ROWS)) || (!consoleCols) || (!consoleRows)) {
+		consoleCols = consoleRows = 0;
+		return;
+	}
+	consoleTop = 0;
+	for (row = 0; row < consoleRows; row++) {
+		psvDebugScreenClearCells(row, 0, consoleCols);
+		for (col = 0; col < consoleCols; col++)
+			consoleShadow[row * (SCREEN_CONSOLE_MAX_COLS) + col].flags = CELL_UNKNOWN;
+		dirtyFrom[row] = consoleCols; // nothing to redraw yet
+		dirtyTo[row] = 0;
+	}
+}
+
+/*
+* Scroll up by one line, the new bottom line is cleared
+*/
+static void psvDebugScreenScrollConsole(void) {
+	consoleTop = (consoleTop + 1) % consoleRows;
+	for (int row = 0; row < consoleRows; row++) psvDebugScreenMarkDirty(row, 0, consoleCols); // every line moved up
+	psvDebugScreenClearCells(consoleRows - 1, 0, consoleCols);
+}
+
+/*
+* Redraw the dirty cells that differ from the framebuffer
+*/
+static void psvDebugScreenFlushConsole(void) {
+	int row, col, drawnFrom, drawnTo;
+	ConsoleCell *cell, *shadow;
+	uint32_t *vram;
+	for (row = 0; row < consoleRows; row++) {
+		if (dirtyFrom[row] >= dirtyTo[row]) continue;
+		cell = psvDebugScreenCell(row, dirtyFrom[row]);
+		shadow = &consoleShadow[row * (SCREEN_CONSOLE_MAX_COLS) + dirtyFrom[row]];
+		if (!memcmp(cell, shadow, (dirtyTo[row] - dirtyFrom[row]) * sizeof(ConsoleCell))) { // whole span already on screen
+			dirtyFrom[row] = consoleCols;
+			dirtyTo[row] = 0;
+			continue;
+		}
+		vram = ((uint32_t*)base) + (dirtyFrom[row] * (F)->size_w) + (row * (F)->size_h * (SCREEN_FB_WIDTH));
+		drawnFrom = consoleCols;
+		drawnTo = 0;
+		for (col = dirtyFrom[row]; col < dirtyTo[row]; col++, cell++, shadow++, vram += (F)->size_w) {
+			if ((cell->flags == shadow->flags) && (cell->color_bg == shadow->color_bg) &&
+			    ((cell->flags & CELL_BLANK) || ((cell->glyph == shadow->glyph) && (cell->color_fg == shadow->color_fg))))
+				continue; // already on screen
+			if (cell->flags & CELL_BLANK) {
+				for (int h = 0; h < (F)->size_h; h++) psvDebugScreenFill(vram + h * (SCREEN_FB_WIDTH), (F)->size_w, cell->color_bg);
+			} else {
+				psvDebugScreenSetDrawColors(cell->color_fg, cell->color_bg);
+				psvDebugScreenDrawGlyph(vram, cell->glyph);
+			}
+			*shadow = *cell;
+			if (col < drawnFrom) drawnFrom = col;
+			drawnTo = col + 1;
+		}
+		if (drawnFrom < drawnTo)
+			psvDebugScreenTouch(drawnFrom * (F)->size_w, row * (F)->size_h, (drawnTo - drawnFrom) * (F)->size_w, (F)->size_h);
+		dirtyFrom[row] = consoleCols;
+		dirtyTo[row] = 0;
+	}
+}
+
+/*
+* Clear part of line (K) or screen (J) like CSI K/J
+*/
+static void psvDebugScreenClearConsole(unsigned int mode, int screen) {
+	int row = coordY / (F)->size_h;
+	int col = coordX / (F)->size_w;
+	int r;
+	if (mode == 0) { // from cursor to end of line/screen
+		psvDebugScreenClearCells(row, col, consoleCols);
+		if (screen) for (r = row + 1; r < consoleRows; r++) psvDebugScreenClearCells(r, 0, consoleCols);
+	} else if (mode == 1) { // from beginning of line/screen to cursor
+		psvDebugScreenClearCells(row, 0, col);
+		if (screen) for (r = 0; (r < row) && (r < consoleRows); r++) psvDebugScreenClearCells(r, 0, consoleCols);
+	} else if (mode == 2) { // whole line/screen
+		if (!screen) psvDebugScreenClearCells(row, 0, consoleCols);
+		else for (r = 0; r < consoleRows; r++) psvDebugScreenClearCells(r, 0, consoleCols);
+	}
+	if (screen) { // pixels right of and below the grid are not part of any cell
+		CLEARSCRNBLOCK(0, consoleRows * (F)->size_h, consoleCols * (F)->size_w, (SCREEN_WIDTH), colors.color_bg);
+		CLEARSCRNLINES(consoleRows * (F)->size_h, screenHeight, colors.color_bg);
+	}
+}
+
 /*
 * Reset foreground color to default
 */
@@ -264,14 +697,14 @@ static void psvDebugScreenSetColors(void) {
 /*
 * Parse CSI sequences
 */
-static size_t psvDebugScreenEscape(const unsigned char *str) {
+static size_t psvDebugScreenEscape(const unsigned char *str, size_t length) {
 	unsigned int i, argc, arg[32] = { 0 };
 	unsigned int c;
 	uint32_t unit, mode;
 	int *colorTrueColorFlag;
 	uint32_t *colorTrueColor;
 	unsigned char *colorIndex, *colorIntensity;
-	for (i = 0, argc = 0; (argc < (sizeof(arg)/sizeof(*arg))) && (str[i] != '\0'); i++) {
+	for (i = 0, argc = 0; (argc < (sizeof(arg)/sizeof(*arg))) && (i < length); i++) {
 		switch (str[i]) {
 			// numeric char
 			case '0':
@@ -314,15 +747,17 @@ static size_t psvDebugScreenEscape(const unsigned char *str) {
 			// clear part of "J"=screen or "K"=Line, so J code re-uses part of K
 			case 'J':
 			case 'K':
-				if (arg[0]==0) { // from cursor to end of line/screen
+				if (consoleRows) {
+					psvDebugScreenClearConsole(arg[0], str[i]=='J');
+				} else if (arg[0]==0) { // from cursor to end of line/screen
 					CLEARSCRNBLOCK(coordY, coordY + (F)->size_h, coordX, (SCREEN_WIDTH), colors.color_bg); // line
-					if (str[i]=='J') CLEARSCRNLINES(coordY + (F)->size_h, (SCREEN_HEIGHT), colors.color_bg); // screen
+					if (str[i]=='J') CLEARSCRNLINES(coordY + (F)->size_h, screenHeight, colors.color_bg); // screen
 				} else if (arg[0]==1) { // from beginning of line/screen to cursor
 					CLEARSCRNBLOCK(coordY, coordY + (F)->size_h, 0, coordX, colors.color_bg); // line
 					if (str[i]=='J') CLEARSCRNLINES(0, coordY, colors.color_bg); // screen
 				} else if (arg[0]==2) { // whole line/screen
 					if (str[i]=='K') CLEARSCRNLINES(coordY, coordY + (F)->size_h, colors.color_bg) // line
-					else if (str[i]=='J') CLEARSCRNLINES(0, (SCREEN_HEIGHT), colors.color_bg); // screen
+					else if (str[i]=='J') CLEARSCRNLINES(0, screenHeight, colors.color_bg); // screen
 				}
 				return i;
 			// color
@@ -401,6 +836,8 @@ static size_t psvDebugScreenEscape(const unsigned char *str) {
 				return i;
 		}
 	}
+	// cut off by the end of the text, drop the rest of it
+	if (i >= length) return length ? length - 1 : 0;
 	return 0;
 }
 
@@ -412,6 +849,7 @@ int psvDebugScreenInit() {
 	psvDebugScreenResetBgColor();
 	psvDebugScreenResetInversion();
 	psvDebugScreenSetColors();
+	psvDebugScreenLayoutConsole();
 
 #ifdef NO_psvDebugScreenInit
 	psvDebugScreenInitReplacement();
@@ -420,40 +858,121 @@ int psvDebugScreenInit() {
 	mutex = sceKernelCreateMutex("log_mutex", 0, 0, NULL);
 	SceUID displayblock = sceKernelAllocMemBlock("display", SCE_KERNEL_MEMBLOCK_TYPE_USER_CDRAM_RW, (SCREEN_FB_SIZE), NULL);
 	sceKernelGetMemBlockBase(displayblock, (void**)&base);
+	displayBase = base;
 	SceDisplayFrameBuf frame = { sizeof(frame), base, (SCREEN_FB_WIDTH), 0, (SCREEN_WIDTH), (SCREEN_HEIGHT) };
 	return sceDisplaySetFrameBuf(&frame, SCE_DISPLAY_SETBUF_NEXTFRAME);
 #endif
 }
 
 /*
-* Draw text onto debug screen
+* Return index of the first "\e", "\n", "\r" or "\t" in text, length if there is none
 */
-int psvDebugScreenPuts(const char * _text) {
-	const unsigned char*text = (const unsigned char*)_text;
-	int c;
+static size_t psvDebugScreenFindSpecial(const unsigned char *text, size_t length) {
+	size_t i = 0, end;
+	uint64_t word;
+	while (i < length) {
+		if (i + 8 <= length) {
+			// all special characters are control characters (< 0x20): skip 8 bytes at once if there is none
+			memcpy(&word, text + i, sizeof(word));
+			if (!((word - 0x2020202020202020ull) & ~word & 0x8080808080808080ull)) {
+				i += 8;
+				continue;
+			}
+			end = i + 8;
+		} else {
+			end = length;
+		}
+		for (; i < end; i++)
+			if ((text[i] == '\e') || (text[i] == '\n') || (text[i] == '\r') || (text[i] == '\t')) return i;
+	}
+	return length;
+}
+
+/*
+* Move to the next line if the glyph does not fit in the line, scroll up (or start over at the top)
+* if it does not fit on the screen
+*/
+static void psvDebugScreenFitGlyph(void) {
+	if (consoleRows) {
+		// check if glyph fits in line
+		if ((coordX / (F)->size_w) >= consoleCols) {
+			coordY += (F)->size_h;
+			coordX = 0;
+		}
+		// check if glyph fits in screen, scroll up otherwise
+		for (; (coordY / (F)->size_h) >= consoleRows; coordY -= (F)->size_h)
+			psvDebugScreenScrollConsole();
+	} else {
+		// check if glyph fits in line
+		if ((coordX + (F)->width) > (SCREEN_WIDTH)) {
+			coordY += (F)->size_h;
+			coordX = 0;
+		}
+		// check if glyph fits in screen
+		if ((coordY + (F)->height) > screenHeight) {
+			coordX = coordY = 0;
+		}
+	}
+}
+
+/*
+* Write a run of glyphs without special characters, a line of cells at a time
+*/
+static void psvDebugScreenWriteGlyphs(const unsigned char *text, size_t length) {
+	ConsoleCell *cell;
+	int row, col, count, i;
+	while (length) {
+		psvDebugScreenFitGlyph();
+		if (consoleRows) {
+			row = coordY / (F)->size_h;
+			col = coordX / (F)->size_w;
+			count = ((size_t)(consoleCols - col) < length) ? consoleCols - col : (int)length;
+			for (i = 0, cell = psvDebugScreenCell(row, col); i < count; i++, cell++) {
+				cell->color_fg = colors.color_fg;
+				cell->color_bg = colors.color_bg;
+				cell->glyph = text[i];
+				cell->flags = 0;
+				cell->unused = 0;
+			}
+			psvDebugScreenMarkDirty(row, col, col + count); // drawn by psvDebugScreenFlushConsole()
+		} else {
+			count = 1;
+			psvDebugScreenSetDrawColors(colors.color_fg, colors.color_bg);
+			psvDebugScreenDrawGlyph(((uint32_t*)base) + coordX + (coordY * (SCREEN_FB_WIDTH)), *text);
+			psvDebugScreenTouch(coordX, coordY, (F)->size_w, (F)->size_h);
+		}
+		// advance X position
+		coordX += count * (F)->size_w;
+		text += count;
+		length -= count;
+	}
+}
+
+/*
+* Write text into the console (or draw it without console), caller holds the mutex and flushes
+*/
+static size_t psvDebugScreenWrite(const unsigned char *text, size_t length) {
+	size_t c = 0, run;
 	unsigned char t;
-	unsigned char drawDummy;
-	//
-	uint32_t *vram;
-	int bits_per_glyph = ((F)->width * (F)->height);
-	int bitmap_offset;
-	unsigned char *font;
-	int row;
-	int max_row;
-	int col;
-	unsigned char mask;
-	uint32_t *pixel;
 
-	sceKernelLockMutex(mutex, 1, NULL);
-	for (c = 0; text[c] ; c++) {
+	if (consoleFont != F) psvDebugScreenLayoutConsole();
+	while (c < length) {
+		// plain text
+		run = psvDebugScreenFindSpecial(text + c, length - c);
+		if (run) {
+			psvDebugScreenWriteGlyphs(text + c, run);
+			c += run;
+			continue;
+		}
 		t = text[c];
 		// handle CSI sequence
-		if ((t == '\e') && (text[c+1] == '[')) {
-			c += psvDebugScreenEscape(text + c + 2) + 2;
+		if ((t == '\e') && (c + 1 < length) && (text[c+1] == '[')) {
+			c += psvDebugScreenEscape(text + c + 2, length - c - 2) + 3;
 			if (coordX < 0) coordX = 0; // CSI position are 1-based,
 			if (coordY < 0) coordY = 0; // prevent 0-based coordinate from producing a negative X/Y
 			continue;
 		}
+		c++;
 		// handle non-printable characters #1 (line-dependent codes)
 		if (t == '\n') {
 			coordX = 0;
@@ -464,98 +983,140 @@ int psvDebugScreenPuts(const char * _text) {
 			coordX = 0;
 			continue;
 		}
-		// check if glyph fits in line
-		if ((coordX + (F)->width) > (SCREEN_WIDTH)) {
-			coordY += (F)->size_h;
-			coordX = 0;
-		}
-		// check if glyph fits in screen
-		if ((coordY + (F)->height) > (SCREEN_HEIGHT)) {
-			coordX = coordY = 0;
-		}
 		// handle non-printable characters #2
 		if (t == '\t') {
+			psvDebugScreenFitGlyph();
 			coordX += (SCREEN_TAB_W) - (coordX % (SCREEN_TAB_W));
 			continue;
 		}
-
-		// draw glyph or dummy glyph (dotted line in the middle)
-		// works also with not byte-aligned glyphs
-		vram = ((uint32_t*)base) + coordX + (coordY * (SCREEN_FB_WIDTH));
-		row = 0;
-		// check if glyph is available in font
-		if ((t > (F)->last) || (t < (F)->first)) {
-			drawDummy = 1;
-		} else {
-			drawDummy = 0;
-			bitmap_offset = (t - (F)->first) * bits_per_glyph;
-			font = &(F)->glyphs[ (bitmap_offset / 8) ];
-			mask = 1 << 7;
-			for (col = (bitmap_offset % 8); col > 0; col--, mask >>= 1);
-		}
-		// special case: dummy glyph, clear to middle height
-		max_row = 0;
-		if (drawDummy) {
-			max_row = (F)->height / 2;
-			for (; row < max_row; row++, vram += (SCREEN_FB_WIDTH)) {
-				pixel = vram;
-				col = 0;
-				for (; col < (F)->size_w ; col++) {
-					*pixel++ = colors.color_bg;
-				}
-			}
-		}
-		// draw font glyph or dummy glyph
-		if (drawDummy) {
-			max_row++;
-			if (max_row > (F)->height) max_row = (F)->height;
-		} else {
-			max_row = (F)->height;
-		}
-		for (; row < max_row; row++, vram += (SCREEN_FB_WIDTH)) {
-			pixel = vram;
-			col = 0;
-			for (; col < (F)->width ; col++, mask >>= 1) {
-				if (drawDummy) {
-					*pixel++ = (col&1) ? colors.color_fg : colors.color_bg;
-				} else {
-					if (!mask) { font++; mask = 1 << 7; } // no more bits: we exhausted this byte
-					*pixel++ = (*font&mask) ? colors.color_fg : colors.color_bg;
-				}
-			}
-			// right margin
-			for (; col < (F)->size_w ; col++)
-				*pixel++ = colors.color_bg;
-		}
-		// draw bottom margin
-		max_row = (F)->size_h;
-		for (; row < (F)->size_h; row++, vram += (SCREEN_FB_WIDTH))
-			for (pixel = vram, col = 0; col < (F)->size_w ; col++)
-				*pixel++ = colors.color_bg;
-		// advance X position
-		coordX += (F)->size_w;
+		// "\e" without CSI is drawn
+		psvDebugScreenWriteGlyphs(&t, 1);
 	}
+	return (c < length) ? c : length;
+}
+
+/*
+* Draw text onto debug screen
+*/
+int psvDebugScreenPutsN(const char * _text, size_t length) {
+	size_t c;
+
+	sceKernelLockMutex(mutex, 1, NULL);
+	c = psvDebugScreenWrite((const unsigned char*)_text, length);
+	psvDebugScreenFlushConsole();
 	sceKernelUnlockMutex(mutex, 1);
 	return c;
 }
 
+int psvDebugScreenPuts(const char * _text) {
+	return psvDebugScreenPutsN(_text, strlen(_text));
+}
+
 
 /*
 * Printf text onto debug screen
 */
+__attribute__((__format__ (__printf__, 1, 0)))
+static int psvDebugScreenLogVPrintf(const char *format, va_list opt) {
+	uint32_t position = __atomic_load_n(&logEnqueuePosition, __ATOMIC_RELAXED);
+	LogSlot *slot;
+	int32_t turn;
+	int ret;
+
+	// claim a slot
+	for (;;) {
+		slot = &logSlots[position & ((SCREEN_LOG_SLOTS) - 1)];
+		turn = (int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - LOG_LAP(position));
+		if (turn == 0) {
+			if (__atomic_compare_exchange_n(&logEnqueuePosition, &position, position + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+			// position was reloaded by the failed CAS
+		} else if (turn < 0) { // slot of the previous lap is not consumed yet: full
+			__atomic_fetch_add(&logDropped, 1, __ATOMIC_RELAXED);
+			return -1;
+		} else { // another producer took this position
+			position = __atomic_load_n(&logEnqueuePosition, __ATOMIC_RELAXED);
+		}
+	}
+
+	// format into the slot and publish it
+	ret = vsnprintf(slot->text, sizeof(slot->text), format, opt);
+	slot->length = (ret < 0) ? 0 : (ret >= (int)sizeof(slot->text)) ? (int)sizeof(slot->text) - 1 : ret;
+	if (ret < 0) slot->text[0] = '\0';
+	__atomic_store_n(&slot->sequence, LOG_LAP(position) + 1, __ATOMIC_RELEASE);
+	return ret;
+}
+
 __attribute__((__format__ (__printf__, 1, 2)))
 int psvDebugScreenPrintf(const char *format, ...) {
 	char buf[4096];
 
 	va_list opt;
 	va_start(opt, format);
-	int ret = vsnprintf(buf, sizeof(buf), format, opt);
-	psvDebugScreenPuts(buf);
+	int ret;
+	if (__atomic_load_n(&logAsync, __ATOMIC_RELAXED)) {
+		ret = psvDebugScreenLogVPrintf(format, opt);
+	} else {
+		ret = vsnprintf(buf, sizeof(buf), format, opt);
+		if (ret > 0) psvDebugScreenPutsN(buf, (ret < (int)sizeof(buf)) ? (size_t)ret : sizeof(buf) - 1);
+	}
 	va_end(opt);
 
 	return ret;
 }
 
+/*
+* Queue formatted text for psvDebugScreenLogDrain()
+*/
+__attribute__((__format__ (__printf__, 1, 2)))
+int psvDebugScreenLogPrintf(const char *format, ...) {
+	va_list opt;
+	va_start(opt, format);
+	int ret = psvDebugScreenLogVPrintf(format, opt);
+	va_end(opt);
+
+	return ret;
+}
+
+/*
+* Write queued messages in order, stops at a message that is still being formatted
+* messages for the screen are written in one go, so changed cells are only redrawn once
+*/
+int psvDebugScreenLogDrain(PsvDebugScreenLogWriter writer, void *context) {
+	uint32_t position = logDequeuePosition;
+	LogSlot *slot;
+	int count = 0;
+
+	if (!writer) sceKernelLockMutex(mutex, 1, NULL);
+	for (;; position++, count++) {
+		slot = &logSlots[position & ((SCREEN_LOG_SLOTS) - 1)];
+		if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != LOG_LAP(position) + 1) break; // empty
+		if (writer) writer(slot->text, slot->length, context);
+		else psvDebugScreenWrite((const unsigned char*)slot->text, slot->length);
+		__atomic_store_n(&slot->sequence, LOG_LAP(position) + (SCREEN_LOG_SLOTS), __ATOMIC_RELEASE);
+	}
+	logDequeuePosition = position;
+	if (!writer) {
+		psvDebugScreenFlushConsole();
+		sceKernelUnlockMutex(mutex, 1);
+	}
+	return count;
+}
+
+/*
+* Return number of messages dropped because the queue was full
+*/
+unsigned int psvDebugScreenLogDropped(void) {
+	return __atomic_load_n(&logDropped, __ATOMIC_RELAXED);
+}
+
+/*
+* Enable or disable asynchronous logging for psvDebugScreenPrintf()
+*/
+void psvDebugScreenSetAsync(int enable) {
+	__atomic_store_n(&logAsync, enable, __ATOMIC_RELAXED);
+}
+
 /*
 * Return copy of color state
 */
@@ -598,18 +1159,73 @@ PsvDebugScreenFont *psvDebugScreenGetFont(void) {
 	return F;
 }
 
+/*
+* Draw into framebuffer instead of the display, NULL for the display
+*/
+void psvDebugScreenSetFramebuffer(void *framebuffer, int height) {
+	sceKernelLockMutex(mutex, 1, NULL);
+	base = (framebuffer) ? framebuffer : displayBase;
+	screenHeight = ((framebuffer) && (height < (SCREEN_HEIGHT))) ? height : (SCREEN_HEIGHT);
+	coordX = coordY = 0;
+	psvDebugScreenLayoutConsole();
+	touchedX0 = touchedX1 = 0;
+	sceKernelUnlockMutex(mutex, 1);
+}
+
+/*
+* Get pixels drawn since the previous call
+*/
+int psvDebugScreenGetDirtyRect(int *x, int *y, int *w, int *h) {
+	int drawn;
+	sceKernelLockMutex(mutex, 1, NULL);
+	// clip to the frame buffer, coordinates are not checked when drawing
+	if (touchedX0 < 0) touchedX0 = 0;
+	if (touchedY0 < 0) touchedY0 = 0;
+	if (touchedX1 > (SCREEN_WIDTH)) touchedX1 = (SCREEN_WIDTH);
+	if (touchedY1 > screenHeight) touchedY1 = screenHeight;
+	drawn = (touchedX0 < touchedX1) && (touchedY0 < touchedY1);
+	if (drawn) {
+		*x = touchedX0;
+		*y = touchedY0;
+		*w = touchedX1 - touchedX0;
+		*h = touchedY1 - touchedY0;
+	}
+	touchedX0 = touchedX1 = 0;
+	sceKernelUnlockMutex(mutex, 1);
+	return drawn;
+}
+
 /*
 * Set font
 */
 PsvDebugScreenFont *psvDebugScreenSetFont(PsvDebugScreenFont *font) {
-	if ((font) && (font->glyphs)) F = font;
+	if ((font) && (font->glyphs)) {
+		F = font;
+		psvDebugScreenInvalidateGlyphCache();
+	}
 	return F;
 }
 
 /*
-* Return scaled-by-2 copy of font
+* Append the count (0-32) low bits of value to the bitmap, msb first
 */
-PsvDebugScreenFont *psvDebugScreenScaleFont2x(PsvDebugScreenFont *source_font) {
+typedef struct BitWriter {
+	unsigned char *byte;
+	uint64_t pending;
+	int pending_bits; // 0-7 bits not yet written to byte
+} BitWriter;
+
+static void psvDebugScreenPutBits(BitWriter *writer, uint32_t value, int count) {
+	writer->pending = (writer->pending << count) | (value & (uint32_t)((1ull << count) - 1));
+	writer->pending_bits += count;
+	for (; writer->pending_bits >= 8; writer->pending_bits -= 8)
+		*writer->byte++ = (unsigned char)(writer->pending >> (writer->pending_bits - 8));
+}
+
+/*
+* Return scaled-by-N copy of font
+*/
+PsvDebugScreenFont *psvDebugScreenScaleFontNx(PsvDebugScreenFont *source_font, int scale) {
 	// works also with not byte-aligned glyphs
 	PsvDebugScreenFont *target_font;
 	size_t size;
@@ -618,25 +1234,29 @@ PsvDebugScreenFont *psvDebugScreenScaleFont2x(PsvDebugScreenFont *source_font) {
 	int row;
 	int col;
 	int count;
-	unsigned char *source_bitmap;
-	unsigned char source_mask;
-	unsigned char *target_bitmap, *target_bitmap2;
-	unsigned char target_mask, target_mask2;
-	int target_next_row_bytes, target_next_row_bits;
-	unsigned char pixel;
+	int source_offset;
+	int chunks;
+	unsigned char bits;
+	uint64_t spread[256]; // each bit of a source byte repeated scale times, lsb aligned
+	uint64_t row_chunks[32]; // scaled source row, 8 source bits per chunk
+	int row_chunk_bits[32];
+	BitWriter writer;
 
 	if (!source_font) return NULL;
+	if ((scale < 1) || (scale > 8)) return NULL;
+	if ((source_font->width * scale > 255) || (source_font->height * scale > 255) ||
+	    (source_font->size_w * scale > 255) || (source_font->size_h * scale > 255)) return NULL;
 
 	// allocate target structure and bitmap
 	target_font = (PsvDebugScreenFont *)malloc(sizeof(PsvDebugScreenFont));
 	memset(target_font, 0, sizeof(PsvDebugScreenFont));
 	// copy and scale meta information
-	target_font->width = 2 * source_font->width;
-	target_font->height = 2 * source_font->height;
+	target_font->width = scale * source_font->width;
+	target_font->height = scale * source_font->height;
 	target_font->first = source_font->first;
 	target_font->last = source_font->last;
-	target_font->size_w = 2 * source_font->size_w;
-	target_font->size_h = 2 * source_font->size_h;
+	target_font->size_w = scale * source_font->size_w;
+	target_font->size_h = scale * source_font->size_h;
 
 	// calculate size of target bitmap
 	size = target_font->width * target_font->height * (target_font->last - target_font->first + 1);
@@ -652,48 +1272,64 @@ PsvDebugScreenFont *psvDebugScreenScaleFont2x(PsvDebugScreenFont *source_font) {
 	target_font->glyphs = (unsigned char *)malloc(size);
 	memset(target_font->glyphs, 0, size);
 
+	// spread lookup table: 8 source pixels become 8 * scale target pixels in one step
+	// (bits >> 1 spreads to the same pixels one pixel group earlier)
+	spread[0] = 0;
+	for (count = 1; count < 256; count++)
+		spread[count] = (spread[count >> 1] << scale) | ((count & 1) ? (1ull << scale) - 1 : 0);
+
+	// byte-aligned rows: spread whole bytes and duplicate the finished row
+	if ((source_font->width % 8) == 0) {
+		int source_row_bytes = source_font->width / 8;
+		int target_row_bytes = source_row_bytes * scale;
+		unsigned char *source_bitmap = source_font->glyphs;
+		unsigned char *target_bitmap = target_font->glyphs;
+		for (row = (source_font->last - source_font->first + 1) * source_font->height; row > 0; row--) {
+			for (col = source_row_bytes; col > 0; col--, source_bitmap++)
+				for (count = scale - 1; count >= 0; count--)
+					*target_bitmap++ = (unsigned char)(spread[*source_bitmap] >> (count * 8));
+			for (count = scale - 1; count > 0; count--, target_bitmap += target_row_bytes)
+				memcpy(target_bitmap, target_bitmap - target_row_bytes, target_row_bytes);
+		}
+		return target_font;
+	}
+
 	// scale source bitmap and store in target bitmap
-	source_bitmap = source_font->glyphs;
-	source_mask = 1 << 7;
-	//
-	target_bitmap = target_font->glyphs;
-	target_mask = 1 << 7;
-	target_next_row_bytes = target_font->width / 8;
-	target_next_row_bits = target_font->width % 8;
-	//
+	source_offset = 0;
+	writer.byte = target_font->glyphs;
+	writer.pending = 0;
+	writer.pending_bits = 0;
 	for (glyph = source_font->first; glyph <= source_font->last; glyph++) {
 		for (row = source_font->height; row > 0; row--) {
-			// Find beginning of next target row
-			target_bitmap2 = target_bitmap + target_next_row_bytes; // advance full bytes
-			target_mask2 = target_mask; // advance remaining bits
-			for (col = target_next_row_bits; col > 0; col--, target_mask2 >>= 1) {
-				if (!target_mask2) { target_bitmap2++; target_mask2 = 1 << 7; } // no more bits: we advance to the next target byte
+			// widen the source row once
+			for (chunks = 0, col = source_font->width; col > 0; col -= count, chunks++, source_offset += count) {
+				count = (col < 8) ? col : 8;
+				bits = psvDebugScreenGlyphBits(source_font->glyphs, source_offset, count);
+				row_chunks[chunks] = spread[bits] >> ((8 - count) * scale);
+				row_chunk_bits[chunks] = count * scale;
 			}
-			// Get pixel from source bitmap
-			for (col = source_font->width; col > 0; col--, source_mask >>= 1) {
-				if (!source_mask) { source_bitmap++; source_mask = 1 << 7; } // no more bits: we advance to the next source byte
-				pixel = *source_bitmap & source_mask;
-				// Put pixels into target bitmap
-				for (count = 2; count > 0; count--) {
-					// duplicate column in origial row
-					if (!target_mask) { target_bitmap++; target_mask = 1 << 7; } // no more bits: we advance to the next target byte
-					if (pixel) *target_bitmap |= target_mask;
-					target_mask >>= 1;
-					// duplicate column in duplicated row
-					if (!target_mask2) { target_bitmap2++; target_mask2 = 1 << 7; } // no more bits: we advance to the next target byte
-					if (pixel) *target_bitmap2 |= target_mask2;
-					target_mask2 >>= 1;
+			// and write it scale times
+			for (count = scale; count > 0; count--) {
+				for (col = 0; col < chunks; col++) {
+					if (row_chunk_bits[col] > 32) psvDebugScreenPutBits(&writer, (uint32_t)(row_chunks[col] >> 32), row_chunk_bits[col] - 32);
+					psvDebugScreenPutBits(&writer, (uint32_t)row_chunks[col], (row_chunk_bits[col] > 32) ? 32 : row_chunk_bits[col]);
 				}
 			}
-			// Next target row is directly behind duplicated row
-			target_bitmap = target_bitmap2;
-			target_mask = target_mask2;
 		}
 	}
+	// remaining bits of the last byte
+	if (writer.pending_bits) *writer.byte = (unsigned char)(writer.pending << (8 - writer.pending_bits));
 
 	return target_font;
 }
 
+/*
+* Return scaled-by-2 copy of font
+*/
+PsvDebugScreenFont *psvDebugScreenScaleFont2x(PsvDebugScreenFont *source_font) {
+	return psvDebugScreenScaleFontNx(source_font, 2);
+}
+
 #undef SCREEN_TAB_W
 #undef F
 
@@ -1,6 +1,8 @@
 #ifndef DEBUG_SCREEN_H
 #define DEBUG_SCREEN_H
 
+#include <stddef.h> // for size_t
+
 #include "debugScreen_custom.h"
 
 typedef struct ColorState {
@@ -28,6 +30,9 @@ typedef struct ColorState {
 	uint32_t color_bg; // color in RGB (internal BGR)
 } ColorState;
 
+// receives queued log messages from psvDebugScreenLogDrain(), text is NUL-terminated
+typedef void (*PsvDebugScreenLogWriter)(const char *text, int length, void *context);
+
 typedef struct PsvDebugScreenFont {
 	unsigned char *glyphs, width, height, first, last, size_w, size_h; // only values 0-255
 } PsvDebugScreenFont;
@@ -43,13 +48,21 @@ extern "C" {
 #endif
 int psvDebugScreenInit();
 int psvDebugScreenPuts(const char * _text);
+int psvDebugScreenPutsN(const char * _text, size_t length);
 int psvDebugScreenPrintf(const char *format, ...);
+int psvDebugScreenLogPrintf(const char *format, ...);
+int psvDebugScreenLogDrain(PsvDebugScreenLogWriter writer, void *context);
+unsigned int psvDebugScreenLogDropped(void);
+void psvDebugScreenSetAsync(int enable);
 void psvDebugScreenGetColorStateCopy(ColorState *copy);
 void psvDebugScreenGetCoordsXY(int *x, int *y);
 void psvDebugScreenSetCoordsXY(int *x, int *y);
+void psvDebugScreenSetFramebuffer(void *framebuffer, int height);
+int psvDebugScreenGetDirtyRect(int *x, int *y, int *w, int *h);
 PsvDebugScreenFont *psvDebugScreenGetFont(void);
 PsvDebugScreenFont *psvDebugScreenSetFont(PsvDebugScreenFont *font);
 PsvDebugScreenFont *psvDebugScreenScaleFont2x(PsvDebugScreenFont *source_font);
+PsvDebugScreenFont *psvDebugScreenScaleFontNx(PsvDebugScreenFont *source_font, int scale);
 #ifdef __cplusplus
 }
 #endif
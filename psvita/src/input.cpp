@@ -0,0 +1,102 @@
+#include "input.h"
+
+static float ClampVelocity(float velocity) {
+    if (velocity < -1.0f) {
+        return -1.0f;
+    }
+    if (velocity > 1.0f) {
+        return 1.0f;
+    }
+    return velocity;
+}
+
+// The ctrl buffer is read oldest first, but the samples are sorted anyways so a source
+// handing them out in any order still integrates correctly (at most 64 samples so insertion sort is fine)
+static void SortSamplesByTimeStamp(CtrlSample* samples, int count) {
+    for (int i = 1; i < count; ++i) {
+        CtrlSample sample = samples[i];
+        int j = i - 1;
+        for (; j >= 0 && samples[j].timeStamp > sample.timeStamp; --j) {
+            samples[j + 1] = samples[j];
+        }
+        samples[j + 1] = sample;
+    }
+}
+
+void InitInputState(InputState* state) {
+    state->lastCtrlTimeStamp = 0;
+    state->buttons = 0;
+    state->velocity = 0.0f;
+    state->touch = TouchSample{ 0, 0, 0, 0 };
+}
+
+float GetCtrlSampleVelocity(const CtrlSample& sample) {
+    float velocity = 0.0f;
+
+    // d-pad moves at full speed, holding both directions cancels out
+    if (sample.buttons & INPUT_BUTTON_LEFT) {
+        velocity -= 1.0f;
+    }
+    if (sample.buttons & INPUT_BUTTON_RIGHT) {
+        velocity += 1.0f;
+    }
+
+    // analog stick moves proportionally to how far it is pushed
+    int offset = sample.lx - ANALOG_CENTER;
+    if (offset > ANALOG_DEADZONE || offset < -ANALOG_DEADZONE) {
+        int sign = offset < 0 ? -1 : 1;
+        int range = (offset < 0 ? ANALOG_CENTER : 255 - ANALOG_CENTER) - ANALOG_DEADZONE;
+        velocity += sign * (float)(offset * sign - ANALOG_DEADZONE) / range;
+    }
+
+    return ClampVelocity(velocity);
+}
+
+float GetTouchVelocity(const TouchSample& touch, float paddleCenterX) {
+    if (touch.reportCount <= 0) {
+        return 0.0f;
+    }
+
+    return ClampVelocity((touch.x - paddleCenterX) / TOUCH_FULL_SPEED_DISTANCE);
+}
+
+FrameInput ReadFrameInput(InputState* state, InputSampleSource* source, float paddleCenterX) {
+    FrameInput input{ state->buttons, 0, 0.0f };
+
+    TouchSample touches[MAX_TOUCH_SAMPLES];
+    int touchCount = source->peekTouchSamples(touches, MAX_TOUCH_SAMPLES);
+    for (int i = 0; i < touchCount; ++i) {
+        if (touches[i].timeStamp >= state->touch.timeStamp) {
+            state->touch = touches[i];
+        }
+    }
+    // touch samples are coarser than ctrl samples, so the newest one steers the paddle for the whole frame
+    float touchVelocity = GetTouchVelocity(state->touch, paddleCenterX);
+
+    CtrlSample samples[MAX_CTRL_SAMPLES];
+    int count = source->peekCtrlSamples(samples, MAX_CTRL_SAMPLES);
+    SortSamplesByTimeStamp(samples, count);
+
+    // velocity is constant between two samples, so integrate it over the time between their timestamps
+    float travel = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        const CtrlSample& sample = samples[i];
+        if (sample.timeStamp <= state->lastCtrlTimeStamp) {
+            continue;
+        }
+
+        if (state->lastCtrlTimeStamp != 0) {
+            uint64_t elapsed = sample.timeStamp - state->lastCtrlTimeStamp;
+            travel += ClampVelocity(state->velocity + touchVelocity) * elapsed;
+        }
+
+        input.pressedButtons |= sample.buttons & ~state->buttons;
+        state->buttons = sample.buttons;
+        state->velocity = GetCtrlSampleVelocity(sample);
+        state->lastCtrlTimeStamp = sample.timeStamp;
+    }
+
+    input.heldButtons = state->buttons;
+    input.paddleTravel = travel / 1000000;
+    return input;
+}
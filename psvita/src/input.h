@@ -0,0 +1,82 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+// Button masks matching SCE_CTRL_* from psp2/ctrl.h so samples can be copied over as is.
+// They are redefined here so the input code builds (and can be fed by a fake source) off-device
+const unsigned int INPUT_BUTTON_SELECT = 0x00000001;
+const unsigned int INPUT_BUTTON_START = 0x00000008;
+const unsigned int INPUT_BUTTON_UP = 0x00000010;
+const unsigned int INPUT_BUTTON_RIGHT = 0x00000020;
+const unsigned int INPUT_BUTTON_DOWN = 0x00000040;
+const unsigned int INPUT_BUTTON_LEFT = 0x00000080;
+const unsigned int INPUT_BUTTON_TRIANGLE = 0x00001000;
+const unsigned int INPUT_BUTTON_CIRCLE = 0x00002000;
+const unsigned int INPUT_BUTTON_CROSS = 0x00004000;
+const unsigned int INPUT_BUTTON_SQUARE = 0x00008000;
+
+// the ctrl buffer of the Vita holds up to 64 samples
+const int MAX_CTRL_SAMPLES = 64;
+const int MAX_TOUCH_SAMPLES = 8;
+
+// analog stick values range from 0 to 255 with 128 being the center
+const int ANALOG_CENTER = 128;
+const int ANALOG_DEADZONE = 20;
+// distance (in screen pixels) between a touch and the center of the paddle that moves the paddle at full speed
+const float TOUCH_FULL_SPEED_DISTANCE = 120.0f;
+
+struct CtrlSample {
+    uint64_t timeStamp; // microseconds
+    unsigned int buttons;
+    unsigned char lx; // left analog stick x axis
+    unsigned char ly; // left analog stick y axis
+};
+
+struct TouchSample {
+    uint64_t timeStamp; // microseconds
+    int reportCount; // 0 if the panel is not being touched
+    int x; // x position of the first touch in screen pixels
+    int y; // y position of the first touch in screen pixels
+};
+
+// Where samples come from. The Vita implementation reads the ctrl and touch buffers,
+// a fake implementation can hand out scripted samples when running on a desktop
+class InputSampleSource {
+public:
+    virtual ~InputSampleSource() {}
+
+    // Copies up to maxSamples of the most recent ctrl samples into samples and returns how many were copied.
+    // Samples may overlap with ones returned by a previous call, they are filtered by timestamp
+    virtual int peekCtrlSamples(CtrlSample* samples, int maxSamples) = 0;
+    // Same as above for the front touch panel
+    virtual int peekTouchSamples(TouchSample* samples, int maxSamples) = 0;
+};
+
+struct InputState {
+    uint64_t lastCtrlTimeStamp; // newest ctrl sample consumed so far, 0 if none
+    unsigned int buttons; // buttons held in the newest ctrl sample
+    float velocity; // paddle velocity of the newest ctrl sample from -1 (full speed left) to 1 (full speed right)
+    TouchSample touch; // newest touch sample
+};
+
+struct FrameInput {
+    unsigned int heldButtons; // buttons held in the newest sample
+    unsigned int pressedButtons; // buttons that went down in any sample since the previous frame
+    // paddle displacement in seconds at full paddle speed, multiply by the paddle speed to get units
+    float paddleTravel;
+};
+
+void InitInputState(InputState* state);
+
+// Velocity from -1 to 1 given by the d-pad and the left analog stick of a single ctrl sample
+float GetCtrlSampleVelocity(const CtrlSample& sample);
+
+// Velocity from -1 to 1 that moves the paddle towards the touched position, 0 if the panel is not touched
+float GetTouchVelocity(const TouchSample& touch, float paddleCenterX);
+
+// Consumes every sample that arrived since the previous call, integrating the paddle velocity
+// over the sample timestamps so no sample between frames is lost
+FrameInput ReadFrameInput(InputState* state, InputSampleSource* source, float paddleCenterX);
+
+#endif
@@ -1,5 +1,4 @@
 #include <psp2/kernel/processmgr.h>
-#include <psp2/ctrl.h>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
@@ -7,144 +6,40 @@
 // Include bool type only required for C
 #include <stdbool.h>
 
+#include <stdio.h>
+
 // RNG
 #include <stdlib.h>
 #include <time.h>
 
-#include <unordered_map>
-#include <string>
+#include "allocationCounter.h"
+#include "assetLoader.h"
+#include "framePacer.h"
+#include "game.h"
+#include "gameRenderer.h"
+#include "latencyProbe.h"
+#include "renderScaler.h"
 
 #include "debugScreen.h"
+#include "input.h"
+#include "perfHud.h"
+#include "vitaInputSource.h"
 
 #define printf psvDebugScreenPrintf
 
-//Screen dimension constants
-enum {
-  WIDTH  = 960,
-  HEIGHT = 544
-};
-
 SDL_Window    * gWindow   = NULL;
 SDL_Renderer  * gRenderer = NULL;
 
-const int TARGET_FRAME_RATE = 60;
-const int TARGET_MILLIS_PER_FRAME = ((float)1 / TARGET_FRAME_RATE) * 1000;
-
-const int STARTING_LIVES = 3;
-// measured in meters per second
-const int BALL_SPEED = 250;
-
-const int BRICKS_PER_LAYER = 13;
-const int LAYERS = 8;
-const int BRICKS_COUNT = BRICKS_PER_LAYER * LAYERS;
-const int BRICK_WIDTH = 70;
-const int BRICK_HEIGHT = 15;
-const int BRICK_HORIZ_PADDING = 3;
-const int BRICK_VERT_PADDING = 5;
-const int CEILING_OFFSET = 30;
-
-const SDL_Color CYAN{ 0, 255, 255, 255 };
-const SDL_Color PURPLE{ 128, 0, 128, 255 };
-const SDL_Color BLUE{ 0, 0, 255, 255 };
-const SDL_Color GREEN{ 0, 255, 0, 255 };
-const SDL_Color YELLOW{ 255, 255, 0, 255 };
-const SDL_Color ORANGE{ 255, 165, 0, 255 };
-const SDL_Color RED{ 255, 0, 0, 255 };
-const SDL_Color PINK{ 255, 192, 203, 255 };
-
-const SDL_Color BRICK_COLORS[LAYERS]{ PINK, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, CYAN };
-
-enum class ColorLabel {
-    PINK = 0, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, CYAN
-};
-
-void initBrickPositions(SDL_Rect* bricks, int layerCount, int bricksPerLayer, int width, int height, int horizPadding, int vertPadding) {
-    for (int i = 0; i < layerCount; ++i) {
-        for (int j = 0; j < bricksPerLayer; ++j) {
-            bricks[i * bricksPerLayer + j] = {
-                (j * (width + horizPadding)) + 6,
-                (i * (height + vertPadding)) + vertPadding + CEILING_OFFSET,
-                width,
-                height
-            };
-        }
-    }
-}
-
-void drawBricks(SDL_Renderer* renderer, SDL_Rect* bricks, bool* bricksCollisionMap, const SDL_Color colors[], int layerCount, int bricksPerLayer) {
-    for (int i = 0; i < layerCount; ++i) {
-        SDL_SetRenderDrawColor(renderer, colors[i].r, colors[i].g, colors[i].b, colors[i].a);
-        for (int j = 0; j < bricksPerLayer; ++j) {
-            if (!bricksCollisionMap[i * bricksPerLayer + j]) {
-                SDL_RenderFillRect(renderer, &bricks[i * bricksPerLayer + j]);
-            }
-        }
-    }
-}
-
-bool canRectanglesOverlap(const SDL_Rect& r1, const SDL_Rect& r2) {
-    return (
-        // Horizontal component
-        r1.x < r2.x + r2.w && r1.x + r1.w > r2.x &&
-        // Vertical component
-        r1.y < r2.y + r2.h && r1.y + r1.h > r2.y
-    );
-}
-
-// return -1 if no collision found
-int checkBrickCollision(SDL_Rect* bricks, bool* bricksCollisionMap, int bricksCount, const SDL_Rect& ball, float xVel, float yVel) {
-    for (int i = 0; i < bricksCount; ++i) {
-        // skip to the next brick if a collision already happened
-        if (bricksCollisionMap[i]) {
-            continue;
-        }
-
-        // Needs improvement: (Ball moving diagonally will sometimes will fail the collision detection
-        // check and cause the ball to go through the next set of bricks above the brick we just hit)
-        // Collision detection can be more accurate by calculating
-        // the point of intersection between a projected point and edge of a brick
-        // What can I do with point of intersection?
-        // Can correct the position of the brick (1 frame) so that it doesn't pass over bricks
-        // it should have not hit in the upcoming frames by setting the ball's position to
-        // the point of intersection
-        // See: https://codeincomplete.com/articles/collision-detection-in-breakout/
-        if (canRectanglesOverlap(ball, bricks[i])) {
-            bricksCollisionMap[i] = true;
-            return i;
-        }
-    }
-
-    return -1;
-}
-
-void ResetBallPosition(SDL_Rect* ball) {
-    ball->x = (WIDTH - ball->w) / 2;
-    ball->y = (HEIGHT - ball->h) / 2;
-}
-
-void SetRandomBallDirection(int* xDir, int* yDir) {
-    int directions[2] = { -1, 1 };
-    *xDir = directions[rand() % 2];
-    *yDir = 1;
-}
-
-void ResetGame(int* score, int* lives, bool* isGameOver, SDL_Rect* ball, int* xDir, int* yDir) {
-    *score = 0;
-    *lives = STARTING_LIVES;
-    *isGameOver = false;
-
-    ResetBallPosition(ball);
-    SetRandomBallDirection(xDir, yDir);
-}
-
-void ResetBrickMap(bool* bricks) {
-    for (int i = 0; i < BRICKS_COUNT; ++i) {
-        bricks[i] = false;
-    }
-}
+// render scales SQUARE cycles through, fewer pixels to fill for a softer picture
+const float RENDER_SCALES[] = { 1.0f, 0.75f, 0.5f };
+const int RENDER_SCALE_COUNT = sizeof(RENDER_SCALES) / sizeof(RENDER_SCALES[0]);
+// frames between presentation reports
+const Uint32 PACER_REPORT_FRAMES = 5 * TARGET_FRAME_RATE;
 
-void ResetPaddlePosition(SDL_Rect* paddle) {
-    paddle->x = (WIDTH - paddle->w) / 2;
+// while the HUD has the debug screen, logged messages go to stdout (the kernel log) instead
+static void WriteLogToStdout(const char* text, int length, void* context)
+{
+    fwrite(text, 1, length, stdout);
 }
 
 int main(int argc, char *argv[]) 
@@ -153,19 +48,11 @@ int main(int argc, char *argv[])
     srand(time(NULL));
 
     psvDebugScreenInit();
+    // printf only queues the message, the frame loop draws them
+    psvDebugScreenSetAsync(1);
 
-    int currentLives = STARTING_LIVES;
-    int currentScore = 0;
-
-    std::unordered_map<ColorLabel, int> scoresTable;
-    scoresTable[ColorLabel::PINK] = 8;
-    scoresTable[ColorLabel::RED] = 7;
-    scoresTable[ColorLabel::ORANGE] = 6;
-    scoresTable[ColorLabel::YELLOW] = 5;
-    scoresTable[ColorLabel::GREEN] = 4;
-    scoresTable[ColorLabel::BLUE] = 3;
-    scoresTable[ColorLabel::PURPLE] = 2;
-    scoresTable[ColorLabel::CYAN] = 1;
+    // counts SDL's allocations too, so it has to be installed before SDL allocates anything
+    InstallAllocationCounter();
 
     if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
         return -1;
@@ -174,291 +61,192 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // fonts and labels are loaded while the window and renderer are created, the first frames are drawn without the UI
+    AssetLoader assets;
+    StartAssetLoader(&assets, "app0:/resources/assets.pak", "fonts.bfnt", "font.otf", 28, "sample.ttf", 48,
+        "Press X to Play Again", "Press Triangle to Unpause");
+
     gWindow = SDL_CreateWindow(
         "BreakoutClone", 
         SDL_WINDOWPOS_UNDEFINED, 
         SDL_WINDOWPOS_UNDEFINED, 
-        WIDTH, 
-        HEIGHT, 
+        GAME_WIDTH, 
+        GAME_HEIGHT, 
         SDL_WINDOW_SHOWN
     );
     if (gWindow == NULL)
         return -1;
 
-    gRenderer = SDL_CreateRenderer(gWindow, -1, 0);
+    gRenderer = SDL_CreateRenderer(gWindow, -1, GetPresentRendererFlags(PresentMode::AUTO));
     if (gRenderer == NULL)
         return -1;
-    
-    TTF_Font* font = TTF_OpenFont("app0:/resources/font.otf", 28);
-    if (font == nullptr) {
-        printf("Font could not be opened! sample.ttf !\n");
-        sceKernelDelayThread(2 * 1000 * 1000);
-        return -1;
-    }
 
-    TTF_Font* bigFont = TTF_OpenFont("app0:/resources/sample.ttf", 48);
-    if (bigFont == nullptr) {
-        return -1;
+    // vsync when the renderer has it, sleeping to the target frame time otherwise
+    FramePacer pacer;
+    InitFramePacer(&pacer, gRenderer, PresentMode::AUTO);
+
+    int renderScaleIndex = 0;
+    RenderScaler scaler;
+    if (!InitRenderScaler(&scaler, gRenderer, RENDER_SCALES[renderScaleIndex])) {
+        printf("Render scaling is not available: %s\n", SDL_GetError());
     }
 
-    int paddleWidth = 150;
-    int paddleHeight = 20;
-    int paddleSpeed = 1000;
-    SDL_Rect paddle{ (WIDTH - paddleWidth) / 2, (HEIGHT - paddleHeight) - 20, paddleWidth, paddleHeight };
+    GameState game;
+    InitGame(&game);
 
-    int ballWidth = 15;
-    int ballHeight = 15;
-    // measured in units per second
-    int ballSpeed = BALL_SPEED;
-    int xDirection;
-    int yDirection;
+    GameLabels labels;
+    bool areAssetsLoaded = false;
+    bool isFirstFrame = true;
 
-    SetRandomBallDirection(&xDirection, &yDirection);
-    SDL_Rect ball{ (WIDTH - ballWidth) / 2, (HEIGHT - ballHeight) / 2, ballWidth, ballHeight };
+    VitaInputSource inputSource;
+    InputState inputState;
+    InitInputState(&inputState);
 
-    SDL_Rect bricks[BRICKS_COUNT];
-    initBrickPositions(bricks, LAYERS, BRICKS_PER_LAYER, BRICK_WIDTH, BRICK_HEIGHT, BRICK_HORIZ_PADDING, BRICK_VERT_PADDING);
+    // Input-to-photon latency measurement mode (toggled with SELECT)
+    LatencyProbe latencyProbe;
+    InitLatencyProbe(&latencyProbe, false);
+    float previousVelocity = 0.0f;
 
-    bool bricksCollisionMap[BRICKS_COUNT];
-    for (int i = 0; i < BRICKS_COUNT; ++i) {
-        bricksCollisionMap[i] = false;
+    // Performance HUD (toggled with START)
+    PerfHud perfHud;
+    if (!InitPerfHud(&perfHud, gRenderer)) {
+        printf("Performance HUD could not be created: %s\n", SDL_GetError());
     }
 
-    SDL_Color textColor{ 255, 255, 255, 255 };
-    SDL_Surface* surf = TTF_RenderText_Solid(font, "Score: ", textColor);
-    SDL_Texture* scoreLabelTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-    SDL_Rect scoreLabelRect{ 0, 0, 0, 0 };
-    SDL_QueryTexture(scoreLabelTexture, NULL, NULL, &(scoreLabelRect.w), &(scoreLabelRect.h));
-    SDL_FreeSurface(surf);
-
-    surf = TTF_RenderText_Solid(font, "Lives: ", textColor);
-    SDL_Texture* livesLabelTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-    SDL_Rect livesLabelRect{ 0, 0, 0, 0 };
-    SDL_QueryTexture(livesLabelTexture, NULL, NULL, &(livesLabelRect.w), &(livesLabelRect.h));
-    SDL_FreeSurface(surf);
-
-    surf = TTF_RenderText_Solid(bigFont, "Game Over", textColor);
-    SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-    SDL_Rect gameOverRect{ 0, 0, 0, 0 };
-    SDL_QueryTexture(gameOverTexture, NULL, NULL, &(gameOverRect.w), &(gameOverRect.h));
-    SDL_FreeSurface(surf);
-    gameOverRect.x = (WIDTH - gameOverRect.w) / 2;
-    gameOverRect.y = (HEIGHT - gameOverRect.h) / 2;
-
-    surf = TTF_RenderText_Solid(bigFont, "Press X to Play Again", textColor);
-    SDL_Texture* playAgainTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-    SDL_Rect playAgainRect{ 0, 0, 0, 0 };
-    SDL_QueryTexture(playAgainTexture, NULL, NULL, &(playAgainRect.w), &(playAgainRect.h));
-    SDL_FreeSurface(surf);
-    playAgainRect.x = (WIDTH - playAgainRect.w) / 2;
-    playAgainRect.y = (HEIGHT + gameOverRect.h + 100 - playAgainRect.h) / 2;
-
-    surf = TTF_RenderText_Solid(bigFont, "Game Paused", textColor);
-    SDL_Texture* gamePauseTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-    SDL_Rect gamePauseRect{ 0, 0, 0, 0 };
-    SDL_QueryTexture(gamePauseTexture, NULL, NULL, &(gamePauseRect.w), &(gamePauseRect.h));
-    SDL_FreeSurface(surf);
-    gamePauseRect.x = (WIDTH - gamePauseRect.w) / 2;
-    gamePauseRect.y = (HEIGHT - gamePauseRect.y) / 2;
-
-    surf = TTF_RenderText_Solid(bigFont, "Press Triangle to Unpause", textColor);
-    SDL_Texture* pauseLabelTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-    SDL_Rect pauseLabelRect{ 0, 0, 0, 0 };
-    SDL_QueryTexture(pauseLabelTexture, NULL, NULL, &(pauseLabelRect.w), &(pauseLabelRect.h));
-    SDL_FreeSurface(surf);
-    pauseLabelRect.x = (WIDTH - pauseLabelRect.w) / 2;
-    pauseLabelRect.y = (HEIGHT + gamePauseRect.h + 100 - pauseLabelRect.h) / 2;
-
-
-    bool leftPressed = false;
-    bool rightPressed = false;
-
     // measured in 1 / X seconds
     float timeDelta = (TARGET_MILLIS_PER_FRAME / (float)1000);
 
-    bool isGameOver = false;
-    bool isGamePaused = false;
+    GameInput pendingInput{ 0.0f, false, false };
     bool isGameRunning = true;
 
-    SceCtrlData ctrl;
     while (isGameRunning)
     {
-        Uint32 start = SDL_GetTicks();
-
-        // inputs
-        sceCtrlPeekBufferPositive(0, &ctrl, 1);
-
-        if (!isGameOver) {
-            if (!isGamePaused) {
-                if (ctrl.buttons == SCE_CTRL_LEFT)
-                {
-                    paddle.x -= paddleSpeed * timeDelta;
-                }
-                else if (ctrl.buttons == SCE_CTRL_RIGHT)
-                {
-                    paddle.x += paddleSpeed * timeDelta;
-                }
+        if (!areAssetsLoaded) {
+            AssetLoadState assetState = PollAssetLoader(&assets, gRenderer, &labels);
+            if (assetState == ASSETS_FAILED) {
+                printf("Font could not be opened! %s\n", assets.error.c_str());
+                psvDebugScreenLogDrain(NULL, NULL);
+                sceKernelDelayThread(2 * 1000 * 1000);
+                return -1;
             }
-
-            if (ctrl.buttons == SCE_CTRL_TRIANGLE)
-            {
-                isGamePaused = !isGamePaused;
+            areAssetsLoaded = assetState == ASSETS_READY;
+            if (areAssetsLoaded) {
+                SDL_Log("assets loaded from %s with %s fonts in %.2f ms, ready %.2f ms after launch", assets.isFromArchive ? "the archive" : "files",
+                    assets.font.baked ? "baked" : "TTF", GetAssetLoadMillis(assets), sceKernelGetProcessTimeWide() / 1000.0);
             }
         }
 
-        if (isGameOver) {
-            if (ctrl.buttons == SCE_CTRL_CROSS) {
-                isGameOver = false;
-                ResetGame(&currentScore, &currentLives, &isGameOver, &ball, &xDirection, &yDirection);
-                ResetPaddlePosition(&paddle);
-                ResetBrickMap(bricksCollisionMap);
-            }
-        }
-
-        float xVel = xDirection * ballSpeed * timeDelta;
-        float yVel = yDirection * ballSpeed * timeDelta;
-
-        // Screen Bounds Ball Collision Check
-        {
-            if (ball.x + xVel < 0)
-            {
-                xDirection *= -1;
-            }
-
-            if (ball.x + ball.w + xVel > WIDTH)
-            {
-                xDirection *= -1;
-            }
+        BeginPacedFrame(&pacer);
+        Uint64 frameStart = pacer.frameStart;
+        Uint32 allocationsAtStart = GetAllocationCount();
+        gRenderStats = RenderStats();
 
-            // lose live condition
-            if (ball.y + ball.h + yVel > HEIGHT)
-            {
-                if (currentLives - 1 >= 0) {
-                    --currentLives;
-                }
-
-                if (currentLives > 0) {
-                    SetRandomBallDirection(&xDirection, &yDirection);
-                    ResetBallPosition(&ball);
-                }
-                else {
-                    isGameOver = true;
-                }
-            }
+        // inputs
+        // every ctrl sample buffered since the previous frame is consumed, so presses shorter than
+        // a frame and combinations of buttons are no longer lost
+        FrameInput frameInput = ReadFrameInput(&inputState, &inputSource, game.paddle.x + game.paddle.w / 2.0f);
 
-            if (ball.y + yVel < CEILING_OFFSET)
-            {
-                yDirection *= -1;
-            }
+        if (frameInput.pressedButtons & INPUT_BUTTON_SELECT) {
+            latencyProbe.isEnabled = !latencyProbe.isEnabled;
+            latencyProbe.isPending = false;
         }
-
-        // Ball to Paddle Collision Check
-        {
-            if (canRectanglesOverlap(ball, paddle)) {
-                yDirection *= -1;
-            }
+        if (frameInput.pressedButtons & INPUT_BUTTON_START) {
+            SetPerfHudEnabled(&perfHud, !perfHud.isEnabled);
         }
-
-        int brickIndex = checkBrickCollision(bricks, bricksCollisionMap, BRICKS_COUNT, ball, xVel, yVel);
-        if (brickIndex != -1) {
-            yDirection *= -1;
-            // update score
-            int layerIndex = brickIndex / BRICKS_PER_LAYER;
-            currentScore += scoresTable[(ColorLabel)layerIndex];
+        if (frameInput.pressedButtons & INPUT_BUTTON_SQUARE) {
+            renderScaleIndex = (renderScaleIndex + 1) % RENDER_SCALE_COUNT;
+            UpdateRenderScaler(&scaler, gRenderer, RENDER_SCALES[renderScaleIndex]);
+            SDL_Log("render scale %.2f, %dx%d", scaler.renderScale, scaler.target ? scaler.targetWidth : scaler.outputWidth,
+                scaler.target ? scaler.targetHeight : scaler.outputHeight);
         }
-
-        // Move Ball
-        {
-            if (!isGamePaused) {
-                ball.x += xDirection * ballSpeed * timeDelta;
-                ball.y += yDirection * ballSpeed * timeDelta;
-            }
+        if (previousVelocity == 0.0f && inputState.velocity != 0.0f) {
+            RecordInputEvent(&latencyProbe, inputState.lastCtrlTimeStamp);
         }
+        previousVelocity = inputState.velocity;
+
+        // d-pad, analog stick and touch give a proportional velocity integrated over the sample timestamps
+        GameInput input{
+            frameInput.paddleTravel,
+            (frameInput.pressedButtons & INPUT_BUTTON_TRIANGLE) != 0,
+            (frameInput.pressedButtons & INPUT_BUTTON_CROSS) != 0
+        };
+
+        // with vsync a frame runs zero or more steps (see FramePacer), input read meanwhile carries over to the next step
+        pendingInput.paddleTravel += input.paddleTravel;
+        pendingInput.togglePause = pendingInput.togglePause != input.togglePause;
+        pendingInput.restart = pendingInput.restart || input.restart;
+
+        Uint64 simulateStart = SDL_GetPerformanceCounter();
+        for (int step = 0; step < pacer.steps; ++step) {
+            StepGame(&game, pendingInput, timeDelta);
+            pendingInput = GameInput{ 0.0f, false, false };
+        }
+        Uint64 simulateEnd = SDL_GetPerformanceCounter();
 
+        BeginScaledFrame(scaler, gRenderer);
 
-        // RENDER UI
-        {
-            surf = TTF_RenderText_Solid(font, std::to_string(currentScore).c_str(), textColor);
-            SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-            SDL_Rect scoreRect{ 0, 0, 0, 0 };
-            SDL_QueryTexture(scoreTexture, NULL, NULL, &(scoreRect.w), &(scoreRect.h));
-            SDL_FreeSurface(surf);
-            surf = NULL;
-
-            surf = TTF_RenderText_Solid(font, std::to_string(currentLives).c_str(), textColor);
-            SDL_Texture* livesTexture = SDL_CreateTextureFromSurface(gRenderer, surf);
-            SDL_Rect livesRect{ 0, 0, 0, 0 };
-            SDL_QueryTexture(livesTexture, NULL, NULL, &(livesRect.w), &(livesRect.h));
-            SDL_FreeSurface(surf);
-            surf = NULL;
-
-            scoreRect.x = scoreLabelRect.x + scoreLabelRect.w;
-            livesRect.x = WIDTH - livesRect.w;
-            livesLabelRect.x = WIDTH - livesLabelRect.w - livesRect.w;
-
-            if (isGameOver) {
-                SDL_RenderCopy(gRenderer, gameOverTexture, NULL, &gameOverRect);
-                SDL_RenderCopy(gRenderer, playAgainTexture, NULL, &playAgainRect);
-            }
-
-            if (isGamePaused) {
-                SDL_RenderCopy(gRenderer, gamePauseTexture, NULL, &gamePauseRect);
-                SDL_RenderCopy(gRenderer, pauseLabelTexture, NULL, &pauseLabelRect);
-            }
-
-            SDL_RenderCopy(gRenderer, scoreLabelTexture, NULL, &scoreLabelRect);
-            SDL_RenderCopy(gRenderer, livesLabelTexture, NULL, &livesLabelRect);
-            SDL_RenderCopy(gRenderer, scoreTexture, NULL, &scoreRect);
-            SDL_RenderCopy(gRenderer, livesTexture, NULL, &livesRect);
-
-            // destroy on every frame the score and lives textures ~~ may be bad for performance
-            // but should at least solve memory leak issue
-            SDL_DestroyTexture(scoreTexture);
-            SDL_DestroyTexture(livesTexture);
+        // RENDER UI, placeholder frames without it until the assets are loaded
+        if (areAssetsLoaded) {
+            DrawUI(gRenderer, &labels, assets.font, game);
         }
 
-
         // Render Graphics
-        drawBricks(gRenderer, bricks, bricksCollisionMap, BRICK_COLORS, LAYERS, BRICKS_PER_LAYER);
-
-        SDL_SetRenderDrawColor(gRenderer, 255, 255, 255, 255);
-        SDL_RenderFillRect(gRenderer, &paddle);
-        SDL_RenderFillRect(gRenderer, &ball);
+        DrawGame(gRenderer, game);
+        // the HUD stays at full resolution
+        EndScaledFrame(scaler, gRenderer);
+        DrawLatencyFlash(gRenderer, latencyProbe);
+        DrawPerfHud(gRenderer, &perfHud);
+
+        PresentPacedFrame(&pacer, gRenderer);
+        RecordPresent(&latencyProbe, sceKernelGetProcessTimeWide());
+        if (isFirstFrame) {
+            // process time starts at launch
+            SDL_Log("time to first frame: %.2f ms%s", sceKernelGetProcessTimeWide() / 1000.0, areAssetsLoaded ? "" : " (placeholder)");
+            isFirstFrame = false;
+        }
 
-        SDL_RenderPresent(gRenderer);
+        // draw messages logged since the previous frame
+        psvDebugScreenLogDrain(perfHud.isEnabled ? WriteLogToStdout : NULL, NULL);
 
         // Clear buffer
         SDL_SetRenderDrawColor(gRenderer, 0, 0, 0, 255);
         SDL_RenderClear(gRenderer);
 
-        // sleep app if hardware is running this update iteration too fast
-        Uint32 end = SDL_GetTicks();
-        Uint32 tickProcessTime = end - start;
-
-        if (tickProcessTime < TARGET_MILLIS_PER_FRAME)
-        {
-            Uint32 sleepTime = TARGET_MILLIS_PER_FRAME - tickProcessTime;
-            timeDelta = (tickProcessTime + sleepTime) / (float)1000;
-            SDL_Delay(sleepTime);
-        }
-        else
-        {
-            timeDelta = tickProcessTime / (float)1000;
+        // sleep app if hardware is running this update iteration too fast (unless vsync paced it)
+        Uint64 busyEnd = SDL_GetPerformanceCounter();
+        timeDelta = EndPacedFrame(&pacer);
+        // presentation latency in the log every few seconds while the HUD is up
+        if (pacer.frames >= PACER_REPORT_FRAMES) {
+            if (perfHud.isEnabled) {
+                ReportFramePacer(&pacer);
+            }
+            else {
+                ResetFramePacerReport(&pacer);
+            }
         }
+
+        Uint64 frequency = SDL_GetPerformanceFrequency();
+        HudFrameStats frameStats{
+            (SDL_GetPerformanceCounter() - frameStart) * 1000.0 / frequency,
+            (simulateEnd - simulateStart) * 1000.0 / frequency,
+            // SDL_RenderPresent waits for vsync, that is idle time like the sleep
+            (busyEnd - frameStart) * 1000.0 / frequency - pacer.lastPresentMillis,
+            gRenderStats.drawCalls,
+            GetAllocationCount() - allocationsAtStart
+        };
+        RecordHudFrame(&perfHud, frameStats);
     }
 
     // Create a template function that will allow us to destroy multiple resources in one line
     // using ellipsis
     // See: https://www.willusher.io/sdl2%20tutorials/2014/08/01/postscript-1-easy-cleanup
-    SDL_DestroyTexture(gameOverTexture);
-    SDL_DestroyTexture(gamePauseTexture);
-    SDL_DestroyTexture(livesLabelTexture);
-    SDL_DestroyTexture(pauseLabelTexture);
-    SDL_DestroyTexture(playAgainTexture);
-    SDL_DestroyTexture(scoreLabelTexture);
+    DestroyPerfHud(&perfHud);
+    DestroyRenderScaler(&scaler);
+    if (areAssetsLoaded) {
+        DestroyGameLabels(&labels);
+    }
+    DestroyAssetLoader(&assets);
   
-    TTF_CloseFont(font);
-    TTF_CloseFont(bigFont);
     SDL_DestroyRenderer( gRenderer );
     SDL_DestroyWindow( gWindow );
     gWindow = NULL;
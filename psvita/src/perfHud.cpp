@@ -0,0 +1,132 @@
+#include "perfHud.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static double ElapsedMillis(Uint64 from, Uint64 to) {
+    return (to - from) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void ResetHudTotals(PerfHud* hud) {
+    hud->frames = 0;
+    hud->total = HudFrameStats{ 0.0, 0.0, 0.0, 0, 0 };
+    hud->hudMillis = 0.0;
+}
+
+// Rewrites both lines and uploads the pixels that changed
+static void UpdatePerfHud(PerfHud* hud) {
+    double frames = hud->frames > 0 ? hud->frames : 1;
+    double frameMillis = hud->total.frameMillis / frames;
+    double cpuLoad = hud->total.frameMillis > 0.0 ? hud->total.busyMillis * 100.0 / hud->total.frameMillis : 0.0;
+
+    // fields have a fixed width, so only the cells of changed digits are redrawn
+    char text[160];
+    int length = snprintf(text, sizeof(text),
+        "\e[1;1Hframe %6.2f ms %5.1f fps  sim %6.3f ms  cpu %3.0f%%\e[K"
+        "\e[2;1Hdraw calls %5.1f  allocs/frame %6.1f  hud %6.3f ms\e[K",
+        frameMillis, frameMillis > 0.0 ? 1000.0 / frameMillis : 0.0, hud->total.simulateMillis / frames, cpuLoad,
+        hud->total.drawCalls / frames, hud->total.allocations / frames, hud->hudMillis / frames);
+    if (length > (int)sizeof(text) - 1) {
+        length = sizeof(text) - 1;
+    }
+    psvDebugScreenPutsN(text, length);
+
+    SDL_Rect dirty;
+    if (psvDebugScreenGetDirtyRect(&dirty.x, &dirty.y, &dirty.w, &dirty.h)) {
+        SDL_UpdateTexture(hud->texture, &dirty, hud->pixels + dirty.y * SCREEN_WIDTH + dirty.x, SCREEN_WIDTH * sizeof(Uint32));
+    }
+}
+
+bool InitPerfHud(PerfHud* hud, SDL_Renderer* renderer) {
+    hud->isEnabled = false;
+    hud->previousFont = NULL;
+    hud->lastUpdate = 0;
+    ResetHudTotals(hud);
+
+    // debug screen colors are stored as 0xAABBGGRR
+    hud->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH, HUD_HEIGHT);
+    hud->pixels = (Uint32*)calloc(SCREEN_WIDTH * HUD_HEIGHT, sizeof(Uint32));
+    hud->font = psvDebugScreenScaleFontNx(psvDebugScreenGetFont(), HUD_FONT_SCALE);
+    if (hud->texture == NULL || hud->pixels == NULL || hud->font == NULL) {
+        DestroyPerfHud(hud);
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(hud->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureAlphaMod(hud->texture, HUD_ALPHA);
+    return true;
+}
+
+void DestroyPerfHud(PerfHud* hud) {
+    SetPerfHudEnabled(hud, false);
+
+    if (hud->texture != NULL) {
+        SDL_DestroyTexture(hud->texture);
+        hud->texture = NULL;
+    }
+    free(hud->pixels);
+    hud->pixels = NULL;
+    if (hud->font != NULL) {
+        free(hud->font->glyphs);
+        free(hud->font);
+        hud->font = NULL;
+    }
+}
+
+void SetPerfHudEnabled(PerfHud* hud, bool isEnabled) {
+    if (isEnabled == hud->isEnabled || (isEnabled && hud->texture == NULL)) {
+        return;
+    }
+    hud->isEnabled = isEnabled;
+
+    if (isEnabled) {
+        hud->previousFont = psvDebugScreenGetFont();
+        psvDebugScreenSetFont(hud->font);
+        psvDebugScreenSetFramebuffer(hud->pixels, HUD_HEIGHT);
+        psvDebugScreenPuts("\e[2J");
+        ResetHudTotals(hud);
+        hud->lastUpdate = SDL_GetTicks();
+        UpdatePerfHud(hud);
+    }
+    else {
+        psvDebugScreenSetFont(hud->previousFont);
+        psvDebugScreenSetFramebuffer(NULL, 0);
+    }
+}
+
+void RecordHudFrame(PerfHud* hud, const HudFrameStats& stats) {
+    if (!hud->isEnabled) {
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    ++hud->frames;
+    hud->total.frameMillis += stats.frameMillis;
+    hud->total.simulateMillis += stats.simulateMillis;
+    hud->total.busyMillis += stats.busyMillis;
+    hud->total.drawCalls += stats.drawCalls;
+    hud->total.allocations += stats.allocations;
+
+    Uint32 now = SDL_GetTicks();
+    if (now - hud->lastUpdate >= HUD_UPDATE_MILLIS) {
+        UpdatePerfHud(hud);
+        ResetHudTotals(hud);
+        hud->lastUpdate = now;
+    }
+
+    hud->hudMillis += ElapsedMillis(start, SDL_GetPerformanceCounter());
+}
+
+void DrawPerfHud(SDL_Renderer* renderer, PerfHud* hud) {
+    if (!hud->isEnabled) {
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    SDL_Rect rect{ 0, 0, SCREEN_WIDTH, HUD_HEIGHT };
+    SDL_RenderCopy(renderer, hud->texture, NULL, &rect);
+
+    hud->hudMillis += ElapsedMillis(start, SDL_GetPerformanceCounter());
+}
@@ -0,0 +1,54 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <SDL.h>
+
+#include "debugScreen.h"
+
+// Performance HUD, a strip at the top of the screen showing frame statistics in the debug screen font.
+// While it is enabled the debug screen draws into a buffer in main memory instead of the display.
+// The text is only rewritten every HUD_UPDATE_MILLIS with fixed width fields, the debug screen console then
+// only redraws the cells that changed and just that rectangle is uploaded to the texture.
+// Every other frame the HUD costs a single SDL_RenderCopy
+const int HUD_LINES = 2;
+const int HUD_FONT_SCALE = 2; // 16x16 cells from the 8x8 font
+const int HUD_HEIGHT = HUD_LINES * 8 * HUD_FONT_SCALE;
+const Uint32 HUD_UPDATE_MILLIS = 500;
+const Uint8 HUD_ALPHA = 192;
+
+// What the frame loop measured for one frame
+struct HudFrameStats {
+    double frameMillis; // whole frame including the sleep
+    double simulateMillis; // StepGame
+    double busyMillis; // frame without the sleep and SDL_RenderPresent
+    Uint32 drawCalls;
+    Uint32 allocations;
+};
+
+struct PerfHud {
+    bool isEnabled;
+    SDL_Texture* texture; // SCREEN_WIDTH x HUD_HEIGHT
+    Uint32* pixels; // debug screen frame buffer while enabled, same size as the texture
+    PsvDebugScreenFont* font;
+    PsvDebugScreenFont* previousFont; // restored when the HUD is disabled
+    Uint32 lastUpdate;
+    // sums since the last update
+    Uint32 frames;
+    HudFrameStats total;
+    double hudMillis; // time spent updating and drawing the HUD itself
+};
+
+// Returns false if the texture or the buffers could not be created
+bool InitPerfHud(PerfHud* hud, SDL_Renderer* renderer);
+
+void DestroyPerfHud(PerfHud* hud);
+
+// Takes over the debug screen while enabled, it draws to the display again when disabled
+void SetPerfHudEnabled(PerfHud* hud, bool isEnabled);
+
+// Adds a frame to the statistics and rewrites the text once HUD_UPDATE_MILLIS passed
+void RecordHudFrame(PerfHud* hud, const HudFrameStats& stats);
+
+void DrawPerfHud(SDL_Renderer* renderer, PerfHud* hud);
+
+#endif
@@ -0,0 +1,47 @@
+#include "scriptedInputSource.h"
+
+// Copies the newest samples up to time (at most maxSamples and bufferSize of them), oldest first
+template <typename Sample>
+static int PeekSamples(const std::vector<Sample>& script, uint64_t time, int bufferSize, Sample* samples, int maxSamples) {
+    int end = 0;
+    while (end < (int)script.size() && script[end].timeStamp <= time) {
+        ++end;
+    }
+
+    int count = end < bufferSize ? end : bufferSize;
+    if (count > maxSamples) {
+        count = maxSamples;
+    }
+    for (int i = 0; i < count; ++i) {
+        samples[i] = script[end - count + i];
+    }
+
+    return count;
+}
+
+ScriptedInputSource::ScriptedInputSource(int bufferSize) : time(0), bufferSize(bufferSize) {
+}
+
+void ScriptedInputSource::addCtrlSample(uint64_t timeStamp, unsigned int buttons, unsigned char lx, unsigned char ly) {
+    ctrlSamples.push_back(CtrlSample{ timeStamp, buttons, lx, ly });
+}
+
+void ScriptedInputSource::addTouchSample(uint64_t timeStamp, int x, int y) {
+    touchSamples.push_back(TouchSample{ timeStamp, 1, x, y });
+}
+
+void ScriptedInputSource::addTouchRelease(uint64_t timeStamp) {
+    touchSamples.push_back(TouchSample{ timeStamp, 0, 0, 0 });
+}
+
+void ScriptedInputSource::setTime(uint64_t timeStamp) {
+    time = timeStamp;
+}
+
+int ScriptedInputSource::peekCtrlSamples(CtrlSample* samples, int maxSamples) {
+    return PeekSamples(ctrlSamples, time, bufferSize, samples, maxSamples);
+}
+
+int ScriptedInputSource::peekTouchSamples(TouchSample* samples, int maxSamples) {
+    return PeekSamples(touchSamples, time, bufferSize, samples, maxSamples);
+}
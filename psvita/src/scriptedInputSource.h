@@ -0,0 +1,34 @@
+#ifndef SCRIPTED_INPUT_SOURCE_H
+#define SCRIPTED_INPUT_SOURCE_H
+
+#include <vector>
+
+#include "input.h"
+
+// Hands out samples added ahead of time instead of reading the Vita buffers, so the input code can be
+// run on a desktop. Like the ctrl buffer, a peek returns the most recent samples up to the current time,
+// overlapping with the previous peek
+class ScriptedInputSource : public InputSampleSource {
+public:
+    // bufferSize is how many samples the buffer of the source holds, older ones are dropped
+    explicit ScriptedInputSource(int bufferSize = MAX_CTRL_SAMPLES);
+
+    // samples have to be added in timestamp order
+    void addCtrlSample(uint64_t timeStamp, unsigned int buttons, unsigned char lx = ANALOG_CENTER, unsigned char ly = ANALOG_CENTER);
+    void addTouchSample(uint64_t timeStamp, int x, int y);
+    void addTouchRelease(uint64_t timeStamp);
+
+    // samples with a later timestamp are not handed out yet
+    void setTime(uint64_t timeStamp);
+
+    int peekCtrlSamples(CtrlSample* samples, int maxSamples) override;
+    int peekTouchSamples(TouchSample* samples, int maxSamples) override;
+
+private:
+    std::vector<CtrlSample> ctrlSamples;
+    std::vector<TouchSample> touchSamples;
+    uint64_t time;
+    int bufferSize;
+};
+
+#endif
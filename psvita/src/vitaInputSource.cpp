@@ -0,0 +1,47 @@
+#include "vitaInputSource.h"
+
+#include <psp2/ctrl.h>
+#include <psp2/touch.h>
+
+static_assert(INPUT_BUTTON_LEFT == SCE_CTRL_LEFT && INPUT_BUTTON_RIGHT == SCE_CTRL_RIGHT &&
+    INPUT_BUTTON_CROSS == SCE_CTRL_CROSS && INPUT_BUTTON_TRIANGLE == SCE_CTRL_TRIANGLE &&
+    INPUT_BUTTON_SELECT == SCE_CTRL_SELECT, "input button masks must match SCE_CTRL masks");
+
+VitaInputSource::VitaInputSource() {
+    sceCtrlSetSamplingMode(SCE_CTRL_MODE_ANALOG);
+    sceTouchSetSamplingState(SCE_TOUCH_PORT_FRONT, SCE_TOUCH_SAMPLING_STATE_START);
+}
+
+int VitaInputSource::peekCtrlSamples(CtrlSample* samples, int maxSamples) {
+    SceCtrlData ctrl[MAX_CTRL_SAMPLES];
+    if (maxSamples > MAX_CTRL_SAMPLES) {
+        maxSamples = MAX_CTRL_SAMPLES;
+    }
+
+    int count = sceCtrlPeekBufferPositive(0, ctrl, maxSamples);
+    for (int i = 0; i < count; ++i) {
+        samples[i] = CtrlSample{ ctrl[i].timeStamp, ctrl[i].buttons, ctrl[i].lx, ctrl[i].ly };
+    }
+
+    return count < 0 ? 0 : count;
+}
+
+int VitaInputSource::peekTouchSamples(TouchSample* samples, int maxSamples) {
+    SceTouchData touch[MAX_TOUCH_SAMPLES];
+    if (maxSamples > MAX_TOUCH_SAMPLES) {
+        maxSamples = MAX_TOUCH_SAMPLES;
+    }
+
+    int count = sceTouchPeek(SCE_TOUCH_PORT_FRONT, touch, maxSamples);
+    for (int i = 0; i < count; ++i) {
+        // the front panel reports positions at twice the screen resolution (1920x1088)
+        samples[i] = TouchSample{
+            touch[i].timeStamp,
+            (int)touch[i].reportNum,
+            touch[i].reportNum > 0 ? touch[i].report[0].x / 2 : 0,
+            touch[i].reportNum > 0 ? touch[i].report[0].y / 2 : 0
+        };
+    }
+
+    return count < 0 ? 0 : count;
+}
@@ -0,0 +1,16 @@
+#ifndef VITA_INPUT_SOURCE_H
+#define VITA_INPUT_SOURCE_H
+
+#include "input.h"
+
+// Reads the buffered ctrl samples (d-pad, buttons and left analog stick) and the front touch panel of the Vita
+class VitaInputSource : public InputSampleSource {
+public:
+    // switches ctrl sampling to analog mode and starts sampling the front touch panel
+    VitaInputSource();
+
+    int peekCtrlSamples(CtrlSample* samples, int maxSamples) override;
+    int peekTouchSamples(TouchSample* samples, int maxSamples) override;
+};
+
+#endif
@@ -0,0 +1,38 @@
+// Tests of the packed game state searched by the level solver (core/compactGame.h)
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "compactGame.h"
+
+TEST(CompareCompactGames, EveryFieldTellsGamesApart) {
+	GameState state;
+	InitSeededGame(&state, 1);
+	CompactGame game;
+	PackGame(state, &game);
+	EXPECT_EQ(0, CompareCompactGames(game, game));
+
+	// one change per field, in declaration order
+	std::vector<CompactGame> changed(15, game);
+	changed[0].bricks[0] ^= 1;
+	changed[1].bricks[1] ^= 1;
+	changed[2].damagedBricks[0] ^= 1;
+	changed[3].damagedBricks[1] ^= 1;
+	changed[4].randomState += 1;
+	changed[5].paddleRemainder += 0.5f;
+	changed[6].paddleX += 1;
+	changed[7].ballX += 1;
+	changed[8].ballY += 1;
+	changed[9].score += 10;
+	changed[10].xDirection = -changed[10].xDirection;
+	changed[11].yDirection = -changed[11].yDirection;
+	changed[12].lives -= 1;
+	changed[13].level += 1;
+	changed[14].isGameOver = !changed[14].isGameOver;
+	for (size_t i = 0; i < changed.size(); ++i) {
+		int order = CompareCompactGames(game, changed[i]);
+		EXPECT_NE(0, order) << "field " << i;
+		EXPECT_EQ(-order, CompareCompactGames(changed[i], game)) << "field " << i;
+	}
+}
@@ -0,0 +1,290 @@
+// Tests of the PS Vita debug screen (psvita/common/debugScreen.c) against the original implementation
+// (tests/referenceDebugScreen.c)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "debugScreen.h"
+#include "referenceDebugScreen.h"
+
+static size_t GetGlyphBytes(const PsvDebugScreenFont& font) {
+	size_t bits = (size_t)font.width * font.height * (font.last - font.first + 1);
+	return (bits + 7) / 8;
+}
+
+static void FreeFont(PsvDebugScreenFont* font) {
+	free(font->glyphs);
+	free(font);
+}
+
+static void ExpectSameFont(const PsvDebugScreenFont& expected, const PsvDebugScreenFont& actual) {
+	EXPECT_EQ(expected.width, actual.width);
+	EXPECT_EQ(expected.height, actual.height);
+	EXPECT_EQ(expected.first, actual.first);
+	EXPECT_EQ(expected.last, actual.last);
+	EXPECT_EQ(expected.size_w, actual.size_w);
+	EXPECT_EQ(expected.size_h, actual.size_h);
+	ASSERT_EQ(GetGlyphBytes(expected), GetGlyphBytes(actual));
+	EXPECT_EQ(0, memcmp(expected.glyphs, actual.glyphs, GetGlyphBytes(expected)));
+}
+
+// the original 2x routine is the reference, psvDebugScreenScaleFont2x() wraps psvDebugScreenScaleFontNx()
+static void ExpectScaledLikeReference(PsvDebugScreenFont* font) {
+	PsvDebugScreenFont* expected = referenceDebugScreenScaleFont2x(font);
+	PsvDebugScreenFont* scaled = psvDebugScreenScaleFontNx(font, 2);
+	ASSERT_NE(nullptr, scaled);
+	ExpectSameFont(*expected, *scaled);
+	FreeFont(scaled);
+
+	scaled = psvDebugScreenScaleFont2x(font);
+	ASSERT_NE(nullptr, scaled);
+	ExpectSameFont(*expected, *scaled);
+	FreeFont(scaled);
+	FreeFont(expected);
+}
+
+TEST(ScaleFontNx, BuiltInFontTwiceLikeReference) {
+	ExpectScaledLikeReference(psvDebugScreenGetFont());
+}
+
+TEST(ScaleFontNx, UnalignedFontTwiceLikeReference) {
+	// glyph rows of 5, 6 and 7 pixels do not start on a byte, the glyphs do not either
+	const unsigned char sizes[][2] = { { 5, 7 }, { 6, 9 }, { 7, 5 }, { 3, 3 } };
+	srand(1);
+	for (const unsigned char* size : sizes) {
+		PsvDebugScreenFont font{ NULL, size[0], size[1], 32, 126, (unsigned char)(size[0] + 1), (unsigned char)(size[1] + 1) };
+		std::vector<unsigned char> glyphs(GetGlyphBytes(font));
+		for (unsigned char& byte : glyphs) {
+			byte = (unsigned char)rand();
+		}
+		font.glyphs = glyphs.data();
+		SCOPED_TRACE(testing::Message() << (int)size[0] << "x" << (int)size[1]);
+		ExpectScaledLikeReference(&font);
+	}
+}
+
+TEST(ScaleFontNx, TooLargeScaleFails) {
+	EXPECT_EQ(nullptr, psvDebugScreenScaleFontNx(psvDebugScreenGetFont(), 0));
+	EXPECT_EQ(nullptr, psvDebugScreenScaleFontNx(psvDebugScreenGetFont(), 9));
+}
+
+// Random text with the escapes both implementations know: colors, cursor moves and positions, saved positions and
+// clears. Every case starts from a cleared screen and stays above the bottom, where the original wraps to the top
+// and the current one scrolls. rows and columns are the font's cells on the screen
+static std::string GenerateText(unsigned int* seed, int rows, int columns) {
+	static const int SGR_CODES[] = { 0, 1, 2, 22, 7, 27, 30, 31, 32, 33, 34, 35, 36, 37, 39, 40, 41, 42, 43, 44, 45, 46,
+		47, 49, 90, 91, 92, 93, 94, 95, 96, 97, 100, 101, 102, 103, 104, 105, 106, 107 };
+	static const char* const CLEARS[] = { "\e[K", "\e[0K", "\e[1K", "\e[2K", "\e[J", "\e[0J", "\e[1J", "\e[2J" };
+	char escape[32];
+	std::string text;
+	// lowest row the cursor may have reached so far, the case ends before it gets near the bottom
+	int lowestRow = 1;
+	int tokens = 1 + rand_r(seed) % 40;
+	for (int i = 0; i < tokens && lowestRow < rows - 2; ++i) {
+		switch (rand_r(seed) % 12) {
+		case 0:
+			text += "\n";
+			++lowestRow;
+			break;
+		case 1:
+			text += rand_r(seed) % 2 == 0 ? "\r" : "\t";
+			++lowestRow;
+			break;
+		case 2:
+			snprintf(escape, sizeof(escape), "\e[%dm", SGR_CODES[rand_r(seed) % (sizeof(SGR_CODES) / sizeof(SGR_CODES[0]))]);
+			text += escape;
+			break;
+		case 3:
+			snprintf(escape, sizeof(escape), "\e[%d;5;%dm", rand_r(seed) % 2 == 0 ? 38 : 48, rand_r(seed) % 256);
+			text += escape;
+			break;
+		case 4:
+			snprintf(escape, sizeof(escape), "\e[%d;2;%d;%d;%dm", rand_r(seed) % 2 == 0 ? 38 : 48, rand_r(seed) % 256, rand_r(seed) % 256, rand_r(seed) % 256);
+			text += escape;
+			break;
+		case 5: {
+			int row = 1 + rand_r(seed) % (rows / 2);
+			snprintf(escape, sizeof(escape), "\e[%d;%d%c", row, 1 + rand_r(seed) % columns, rand_r(seed) % 2 == 0 ? 'H' : 'f');
+			text += escape;
+			lowestRow = std::max(lowestRow, row);
+			break;
+		}
+		case 6: {
+			int count = 1 + rand_r(seed) % 5;
+			snprintf(escape, sizeof(escape), "\e[%d%c", count, "ABCDEFG"[rand_r(seed) % 7]);
+			text += escape;
+			// C and G may leave the cursor past the end of the line, the next glyph wraps
+			lowestRow += count + 1;
+			break;
+		}
+		case 7:
+			text += CLEARS[rand_r(seed) % (sizeof(CLEARS) / sizeof(CLEARS[0]))];
+			break;
+		case 8:
+			text += rand_r(seed) % 2 == 0 ? "\e[s" : "\e[u";
+			break;
+		case 9: {
+			// outside of the font's characters, drawn as the dummy glyph
+			char c = (char)(128 + rand_r(seed) % 128);
+			text += c;
+			++lowestRow;
+			break;
+		}
+		default: {
+			int length = 1 + rand_r(seed) % 60;
+			for (int j = 0; j < length; ++j) {
+				text += (char)(' ' + rand_r(seed) % 95);
+			}
+			lowestRow += length / columns + 1;
+			break;
+		}
+		}
+	}
+	return text;
+}
+
+class DebugScreenComparison : public testing::Test {
+protected:
+	std::vector<uint32_t> framebuffer;
+
+	void SetUp() override {
+		framebuffer.assign(960 * SCREEN_HEIGHT, 0);
+		psvDebugScreenInit();
+		psvDebugScreenSetFramebuffer(framebuffer.data(), SCREEN_HEIGHT);
+		referenceDebugScreenInit();
+	}
+
+	void TearDown() override {
+		psvDebugScreenSetFramebuffer(NULL, SCREEN_HEIGHT);
+	}
+
+	int GetRows() {
+		return SCREEN_HEIGHT / psvDebugScreenGetFont()->size_h;
+	}
+
+	int GetColumns() {
+		return SCREEN_WIDTH / psvDebugScreenGetFont()->size_w;
+	}
+
+	// both screens cleared and in the default colors, the cursor top left
+	void Reset() {
+		psvDebugScreenPuts("\e[0m\e[H\e[2J");
+		referenceDebugScreenPuts("\e[0m\e[H\e[2J");
+	}
+
+	void ExpectSameFramebuffer(const std::string& text) {
+		const uint32_t* expected = referenceDebugScreenFramebuffer();
+		for (size_t i = 0; i < framebuffer.size(); ++i) {
+			if (framebuffer[i] != expected[i]) {
+				ADD_FAILURE() << "pixel (" << i % 960 << ", " << i / 960 << ") is " << std::hex << framebuffer[i] << " instead of "
+					<< expected[i] << " after " << testing::PrintToString(text);
+				return;
+			}
+		}
+	}
+
+	// through psvDebugScreenPuts(), psvDebugScreenPutsN() and psvDebugScreenPrintf() in turn
+	void CompareRandomText(int cases) {
+		unsigned int seed = 1;
+		for (int i = 0; i < cases; ++i) {
+			Reset();
+			std::string text = GenerateText(&seed, GetRows(), GetColumns());
+			referenceDebugScreenPuts(text.c_str());
+			switch (i % 3) {
+			case 0:
+				psvDebugScreenPuts(text.c_str());
+				break;
+			case 1:
+				psvDebugScreenPutsN(text.data(), text.size());
+				break;
+			default:
+				psvDebugScreenPrintf("%s", text.c_str());
+				break;
+			}
+			ExpectSameFramebuffer(text);
+			if (HasFailure()) {
+				return;
+			}
+		}
+	}
+};
+
+TEST_F(DebugScreenComparison, RandomTextLikeReference) {
+	CompareRandomText(2000);
+}
+
+TEST_F(DebugScreenComparison, RandomTextWithScaledFontLikeReference) {
+	PsvDebugScreenFont* font = psvDebugScreenGetFont();
+	PsvDebugScreenFont* referenceFont = referenceDebugScreenGetFont();
+	PsvDebugScreenFont* scaledFont = psvDebugScreenScaleFontNx(font, 2);
+	PsvDebugScreenFont* referenceScaledFont = referenceDebugScreenScaleFont2x(referenceFont);
+	psvDebugScreenSetFont(scaledFont);
+	referenceDebugScreenSetFont(referenceScaledFont);
+
+	CompareRandomText(500);
+
+	psvDebugScreenSetFont(font);
+	referenceDebugScreenSetFont(referenceFont);
+	FreeFont(scaledFont);
+	FreeFont(referenceScaledFont);
+}
+
+// text split into several calls is drawn like the whole of it
+TEST_F(DebugScreenComparison, SplitTextLikeReference) {
+	unsigned int seed = 2;
+	for (int i = 0; i < 500; ++i) {
+		Reset();
+		std::string text = GenerateText(&seed, GetRows(), GetColumns());
+		referenceDebugScreenPuts(text.c_str());
+		size_t split = text.size() / 2;
+		// not inside an escape
+		while (split > 0 && text.rfind('\e', split) != std::string::npos && text.find_first_of("mHfABCDEFGJKsu", text.rfind('\e', split)) >= split) {
+			--split;
+		}
+		psvDebugScreenPutsN(text.data(), split);
+		psvDebugScreenPutsN(text.data() + split, text.size() - split);
+		ExpectSameFramebuffer(text);
+		if (HasFailure()) {
+			return;
+		}
+	}
+}
+
+// past the bottom the console scrolls up, the original wrapped to the top instead
+TEST_F(DebugScreenComparison, ScrollsLikeTheLastLinesOnAClearScreen) {
+	const int lineCount = 80;
+	const int firstVisibleLine = lineCount + 1 - GetRows(); // the cursor waits below the last row until the next glyph scrolls
+	char line[32];
+	Reset();
+	for (int i = 1; i <= lineCount; ++i) {
+		snprintf(line, sizeof(line), "\e[3%dmline %d\n", i % 8, i);
+		psvDebugScreenPuts(line);
+		if (i >= firstVisibleLine) {
+			referenceDebugScreenPuts(line);
+		}
+	}
+	ExpectSameFramebuffer("80 lines");
+}
+
+// an escape cut off by the length is dropped, the original read on past the end of the text
+TEST_F(DebugScreenComparison, EscapeCutOffAtTheEnd) {
+	const char text[] = "ab\e[31mcd";
+	for (size_t length = 3; length <= 6; ++length) {
+		Reset();
+		// a lone "\e" is drawn like the original did before the terminating 0
+		referenceDebugScreenPuts(length == 3 ? "ab\e" : "ab");
+		psvDebugScreenPutsN(text, length);
+		ExpectSameFramebuffer(std::string(text, length));
+		// the next text starts a new escape
+		psvDebugScreenPuts("\e[32mx");
+		referenceDebugScreenPuts("\e[32mx");
+		ExpectSameFramebuffer(std::string(text, length) + "\e[32mx");
+	}
+}
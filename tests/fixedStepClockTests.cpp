@@ -0,0 +1,47 @@
+// Tests of the fixed game steps run for frames of any length (FixedStepClock in core/game.h)
+
+#include <gtest/gtest.h>
+
+#include "game.h"
+
+// ten minutes of frames
+static const int FRAME_COUNT = 10 * 60 * 60;
+
+TEST(AdvanceFixedStepClock, OneStepOnEveryFrameAt60Hz) {
+	FixedStepClock clock{ 0.0 };
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		ASSERT_EQ(1, AdvanceFixedStepClock(&clock, 1000.0 / 60)) << "frame " << frame;
+	}
+}
+
+TEST(AdvanceFixedStepClock, OneStepOnEveryFrameNear60Hz) {
+	// a 59.94 Hz display, and the refresh interval measured by the frame pacer jittering around 16.67 ms
+	FixedStepClock clock{ 0.0 };
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		ASSERT_EQ(1, AdvanceFixedStepClock(&clock, 1000.0 / 59.94)) << "frame " << frame;
+	}
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		ASSERT_EQ(1, AdvanceFixedStepClock(&clock, frame % 2 == 0 ? 16.55 : 16.8)) << "frame " << frame;
+	}
+}
+
+TEST(AdvanceFixedStepClock, StepsPerSecondAtOtherRefreshRates) {
+	const int refreshRates[] = { 30, 75, 120, 144, 165, 240 };
+	for (int refreshRate : refreshRates) {
+		FixedStepClock clock{ 0.0 };
+		int steps = 0;
+		for (int frame = 0; frame < refreshRate * 60; ++frame) {
+			int frameSteps = AdvanceFixedStepClock(&clock, 1000.0 / refreshRate);
+			// never more than one step ahead of the display
+			EXPECT_LE(frameSteps, (TARGET_FRAME_RATE + refreshRate - 1) / refreshRate) << refreshRate << " Hz";
+			steps += frameSteps;
+		}
+		EXPECT_NEAR(TARGET_FRAME_RATE * 60, steps, 1) << refreshRate << " Hz";
+	}
+}
+
+TEST(AdvanceFixedStepClock, SkipsAheadAfterAStall) {
+	FixedStepClock clock{ 0.0 };
+	EXPECT_EQ(MAX_FIXED_STEPS_PER_FRAME, AdvanceFixedStepClock(&clock, 1000.0));
+	EXPECT_EQ(1, AdvanceFixedStepClock(&clock, 1000.0 / 60));
+}
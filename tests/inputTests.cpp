@@ -0,0 +1,166 @@
+// Tests of the PS Vita input module (psvita/src/input.h) fed by scripted samples
+
+#include <gtest/gtest.h>
+
+#include "input.h"
+#include "scriptedInputSource.h"
+
+// one ctrl sample every 4 ms, about 4 samples per frame at 60 Hz
+static const uint64_t SAMPLE_MICROS = 4000;
+static const float PADDLE_CENTER_X = 480.0f;
+
+static FrameInput ReadFrameAt(InputState* state, ScriptedInputSource* source, uint64_t time) {
+	source->setTime(time);
+	return ReadFrameInput(state, source, PADDLE_CENTER_X);
+}
+
+TEST(ReadFrameInput, OverlappingPeeksAreConsumedOnce) {
+	ScriptedInputSource source;
+	InputState state;
+	InitInputState(&state);
+
+	for (int i = 1; i <= 10; ++i) {
+		source.addCtrlSample(i * SAMPLE_MICROS, INPUT_BUTTON_RIGHT);
+	}
+
+	FrameInput first = ReadFrameAt(&state, &source, 5 * SAMPLE_MICROS);
+	EXPECT_EQ(INPUT_BUTTON_RIGHT, first.pressedButtons);
+	EXPECT_EQ(INPUT_BUTTON_RIGHT, first.heldButtons);
+	EXPECT_FLOAT_EQ(4 * SAMPLE_MICROS / 1000000.0f, first.paddleTravel);
+
+	// the second peek hands out samples 1 to 10 again, only 6 to 10 are new
+	FrameInput second = ReadFrameAt(&state, &source, 10 * SAMPLE_MICROS);
+	EXPECT_EQ(0u, second.pressedButtons);
+	EXPECT_EQ(INPUT_BUTTON_RIGHT, second.heldButtons);
+	EXPECT_FLOAT_EQ(5 * SAMPLE_MICROS / 1000000.0f, second.paddleTravel);
+
+	// nothing new
+	FrameInput third = ReadFrameAt(&state, &source, 11 * SAMPLE_MICROS);
+	EXPECT_EQ(0u, third.pressedButtons);
+	EXPECT_FLOAT_EQ(0.0f, third.paddleTravel);
+}
+
+TEST(ReadFrameInput, ShortBufferDropsOldestSamples) {
+	// a buffer shorter than the samples since the last frame loses the oldest ones,
+	// the travel only counts the time between the samples that were read
+	ScriptedInputSource source(2);
+	InputState state;
+	InitInputState(&state);
+
+	for (int i = 1; i <= 4; ++i) {
+		source.addCtrlSample(i * SAMPLE_MICROS, INPUT_BUTTON_LEFT);
+	}
+	FrameInput input = ReadFrameAt(&state, &source, 4 * SAMPLE_MICROS);
+	EXPECT_FLOAT_EQ(-(float)SAMPLE_MICROS / 1000000.0f, input.paddleTravel);
+}
+
+TEST(ReadFrameInput, PressAndReleaseWithinOneFrame) {
+	ScriptedInputSource source;
+	InputState state;
+	InitInputState(&state);
+
+	source.addCtrlSample(SAMPLE_MICROS, 0);
+	ReadFrameAt(&state, &source, SAMPLE_MICROS);
+
+	source.addCtrlSample(2 * SAMPLE_MICROS, INPUT_BUTTON_CROSS);
+	source.addCtrlSample(3 * SAMPLE_MICROS, 0);
+	FrameInput input = ReadFrameAt(&state, &source, 4 * SAMPLE_MICROS);
+	EXPECT_EQ(INPUT_BUTTON_CROSS, input.pressedButtons);
+	EXPECT_EQ(0u, input.heldButtons);
+
+	// the press is reported once
+	source.addCtrlSample(4 * SAMPLE_MICROS, 0);
+	input = ReadFrameAt(&state, &source, 5 * SAMPLE_MICROS);
+	EXPECT_EQ(0u, input.pressedButtons);
+}
+
+TEST(ReadFrameInput, TwoButtonsAtOnce) {
+	ScriptedInputSource source;
+	InputState state;
+	InitInputState(&state);
+
+	source.addCtrlSample(SAMPLE_MICROS, INPUT_BUTTON_CROSS | INPUT_BUTTON_START);
+	FrameInput input = ReadFrameAt(&state, &source, SAMPLE_MICROS);
+	EXPECT_EQ(INPUT_BUTTON_CROSS | INPUT_BUTTON_START, input.pressedButtons);
+	EXPECT_EQ(INPUT_BUTTON_CROSS | INPUT_BUTTON_START, input.heldButtons);
+
+	// releasing one of them and pressing another one in the same sample only reports the new one
+	source.addCtrlSample(2 * SAMPLE_MICROS, INPUT_BUTTON_START | INPUT_BUTTON_TRIANGLE);
+	input = ReadFrameAt(&state, &source, 2 * SAMPLE_MICROS);
+	EXPECT_EQ(INPUT_BUTTON_TRIANGLE, input.pressedButtons);
+	EXPECT_EQ(INPUT_BUTTON_START | INPUT_BUTTON_TRIANGLE, input.heldButtons);
+}
+
+TEST(GetCtrlSampleVelocity, StickDeadzone) {
+	EXPECT_FLOAT_EQ(0.0f, GetCtrlSampleVelocity(CtrlSample{ 0, 0, ANALOG_CENTER, ANALOG_CENTER }));
+	EXPECT_FLOAT_EQ(0.0f, GetCtrlSampleVelocity(CtrlSample{ 0, 0, ANALOG_CENTER + ANALOG_DEADZONE, ANALOG_CENTER }));
+	EXPECT_FLOAT_EQ(0.0f, GetCtrlSampleVelocity(CtrlSample{ 0, 0, ANALOG_CENTER - ANALOG_DEADZONE, ANALOG_CENTER }));
+
+	// just outside of the deadzone the stick starts from 0 instead of jumping to the deadzone value
+	float right = GetCtrlSampleVelocity(CtrlSample{ 0, 0, ANALOG_CENTER + ANALOG_DEADZONE + 1, ANALOG_CENTER });
+	EXPECT_GT(right, 0.0f);
+	EXPECT_LT(right, 0.02f);
+	float left = GetCtrlSampleVelocity(CtrlSample{ 0, 0, ANALOG_CENTER - ANALOG_DEADZONE - 1, ANALOG_CENTER });
+	EXPECT_LT(left, 0.0f);
+	EXPECT_GT(left, -0.02f);
+
+	EXPECT_FLOAT_EQ(1.0f, GetCtrlSampleVelocity(CtrlSample{ 0, 0, 255, ANALOG_CENTER }));
+	EXPECT_FLOAT_EQ(-1.0f, GetCtrlSampleVelocity(CtrlSample{ 0, 0, 0, ANALOG_CENTER }));
+	// the vertical axis does not move the paddle
+	EXPECT_FLOAT_EQ(0.0f, GetCtrlSampleVelocity(CtrlSample{ 0, 0, ANALOG_CENTER, 0 }));
+	// stick and d-pad add up but never go past full speed
+	EXPECT_FLOAT_EQ(1.0f, GetCtrlSampleVelocity(CtrlSample{ 0, INPUT_BUTTON_RIGHT, 255, ANALOG_CENTER }));
+}
+
+TEST(ReadFrameInput, StickInsideDeadzoneDoesNotMove) {
+	ScriptedInputSource source;
+	InputState state;
+	InitInputState(&state);
+
+	for (int i = 1; i <= 4; ++i) {
+		source.addCtrlSample(i * SAMPLE_MICROS, 0, ANALOG_CENTER + (i % 2 == 0 ? ANALOG_DEADZONE : -ANALOG_DEADZONE), ANALOG_CENTER);
+	}
+	FrameInput input = ReadFrameAt(&state, &source, 4 * SAMPLE_MICROS);
+	EXPECT_FLOAT_EQ(0.0f, input.paddleTravel);
+}
+
+TEST(GetTouchVelocity, SteersTowardsTheTouch) {
+	EXPECT_FLOAT_EQ(0.0f, GetTouchVelocity(TouchSample{ 0, 0, 900, 300 }, PADDLE_CENTER_X));
+	EXPECT_FLOAT_EQ(0.0f, GetTouchVelocity(TouchSample{ 0, 1, (int)PADDLE_CENTER_X, 300 }, PADDLE_CENTER_X));
+	EXPECT_FLOAT_EQ(0.5f, GetTouchVelocity(TouchSample{ 0, 1, (int)(PADDLE_CENTER_X + TOUCH_FULL_SPEED_DISTANCE / 2), 300 }, PADDLE_CENTER_X));
+	EXPECT_FLOAT_EQ(-1.0f, GetTouchVelocity(TouchSample{ 0, 1, 0, 300 }, PADDLE_CENTER_X));
+	EXPECT_FLOAT_EQ(1.0f, GetTouchVelocity(TouchSample{ 0, 1, 959, 300 }, PADDLE_CENTER_X));
+}
+
+TEST(ReadFrameInput, TouchSteering) {
+	ScriptedInputSource source;
+	InputState state;
+	InitInputState(&state);
+
+	source.addCtrlSample(SAMPLE_MICROS, 0);
+	ReadFrameAt(&state, &source, SAMPLE_MICROS);
+
+	// touched half of the full speed distance to the right of the paddle for the whole frame
+	source.addTouchSample(SAMPLE_MICROS, (int)(PADDLE_CENTER_X + TOUCH_FULL_SPEED_DISTANCE / 2), 300);
+	for (int i = 2; i <= 5; ++i) {
+		source.addCtrlSample(i * SAMPLE_MICROS, 0);
+	}
+	FrameInput input = ReadFrameAt(&state, &source, 5 * SAMPLE_MICROS);
+	EXPECT_FLOAT_EQ(0.5f * 4 * SAMPLE_MICROS / 1000000.0f, input.paddleTravel);
+
+	// the d-pad pushing the other way adds up with the touch
+	for (int i = 6; i <= 9; ++i) {
+		source.addCtrlSample(i * SAMPLE_MICROS, INPUT_BUTTON_LEFT);
+	}
+	input = ReadFrameAt(&state, &source, 9 * SAMPLE_MICROS);
+	// the first 4 ms still use the velocity of sample 5 (no button held)
+	EXPECT_FLOAT_EQ((0.5f - 0.5f * 3) * SAMPLE_MICROS / 1000000.0f, input.paddleTravel);
+
+	// lifting the finger stops steering
+	source.addTouchRelease(9 * SAMPLE_MICROS);
+	for (int i = 10; i <= 13; ++i) {
+		source.addCtrlSample(i * SAMPLE_MICROS, 0);
+	}
+	input = ReadFrameAt(&state, &source, 13 * SAMPLE_MICROS);
+	EXPECT_FLOAT_EQ(-(float)SAMPLE_MICROS / 1000000.0f, input.paddleTravel);
+}
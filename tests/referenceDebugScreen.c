@@ -0,0 +1,21 @@
+// The debug screen as it was before the lookup-table blitter, glyph cache, console grid and bulk text path,
+// built under other names so tests and benchmarks can compare the current one with it.
+// reference/debugScreen.c is an unchanged copy, it draws into its own static framebuffer off the Vita
+#define psvDebugScreenFont referenceDebugScreenFont
+#define psvDebugScreenInit referenceDebugScreenInit
+#define psvDebugScreenPuts referenceDebugScreenPuts
+#define psvDebugScreenPrintf referenceDebugScreenPrintf
+#define psvDebugScreenGetColorStateCopy referenceDebugScreenGetColorStateCopy
+#define psvDebugScreenGetCoordsXY referenceDebugScreenGetCoordsXY
+#define psvDebugScreenSetCoordsXY referenceDebugScreenSetCoordsXY
+#define psvDebugScreenGetFont referenceDebugScreenGetFont
+#define psvDebugScreenSetFont referenceDebugScreenSetFont
+#define psvDebugScreenScaleFont2x referenceDebugScreenScaleFont2x
+
+#include "referenceDebugScreen.h"
+
+#include "reference/debugScreen.c"
+
+uint32_t *referenceDebugScreenFramebuffer(void) {
+	return (uint32_t *)base;
+}
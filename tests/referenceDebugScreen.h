@@ -0,0 +1,24 @@
+#ifndef REFERENCE_DEBUG_SCREEN_H
+#define REFERENCE_DEBUG_SCREEN_H
+
+// The original debug screen (see referenceDebugScreen.c), same calls as in debugScreen.h
+#include <stdint.h>
+
+#include "debugScreen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int referenceDebugScreenInit();
+int referenceDebugScreenPuts(const char * _text);
+void referenceDebugScreenGetCoordsXY(int *x, int *y);
+PsvDebugScreenFont *referenceDebugScreenGetFont(void);
+PsvDebugScreenFont *referenceDebugScreenSetFont(PsvDebugScreenFont *font);
+PsvDebugScreenFont *referenceDebugScreenScaleFont2x(PsvDebugScreenFont *source_font);
+// SCREEN_HEIGHT lines of 960 pixels
+uint32_t *referenceDebugScreenFramebuffer(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
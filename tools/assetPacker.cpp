@@ -0,0 +1,144 @@
+// Packs assets into the archive read by core/assetArchive.h
+// Assets are stored under their file name (without directories), the index is sorted by name.
+//
+// usage: asset_packer <archive> <file>...
+//        asset_packer --list <archive>      prints the index and checks the hashes
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "assetArchive.h"
+
+struct PackedAsset {
+	std::string name;
+	std::vector<unsigned char> data;
+};
+
+static bool ReadFile(const char* path, std::vector<unsigned char>* data) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	data->clear();
+	unsigned char buffer[64 * 1024];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		data->insert(data->end(), buffer, buffer + count);
+	}
+	bool isRead = !ferror(file);
+	fclose(file);
+	return isRead;
+}
+
+static std::string FileName(const std::string& path) {
+	size_t separator = path.find_last_of("/\\");
+	return separator == std::string::npos ? path : path.substr(separator + 1);
+}
+
+static bool SortByName(const PackedAsset& a, const PackedAsset& b) {
+	return strcmp(a.name.c_str(), b.name.c_str()) < 0;
+}
+
+static int Pack(const char* archivePath, int fileCount, char** files) {
+	std::vector<PackedAsset> assets(fileCount);
+	for (int i = 0; i < fileCount; ++i) {
+		assets[i].name = FileName(files[i]);
+		if (assets[i].name.size() >= (size_t)ASSET_NAME_SIZE) {
+			fprintf(stderr, "Asset name too long (max %d characters): %s\n", ASSET_NAME_SIZE - 1, assets[i].name.c_str());
+			return 1;
+		}
+		if (!ReadFile(files[i], &assets[i].data)) {
+			fprintf(stderr, "Unable to read %s\n", files[i]);
+			return 1;
+		}
+	}
+	std::sort(assets.begin(), assets.end(), SortByName);
+	for (size_t i = 1; i < assets.size(); ++i) {
+		if (assets[i].name == assets[i - 1].name) {
+			fprintf(stderr, "Duplicate asset name: %s\n", assets[i].name.c_str());
+			return 1;
+		}
+	}
+
+	AssetArchiveHeader header = AssetArchiveHeader();
+	memcpy(header.magic, ASSET_ARCHIVE_MAGIC, sizeof(header.magic));
+	header.version = ASSET_ARCHIVE_VERSION;
+	header.entryCount = (Uint32)assets.size();
+
+	std::vector<AssetArchiveEntry> entries(assets.size(), AssetArchiveEntry());
+	size_t offset = sizeof(AssetArchiveHeader) + entries.size() * sizeof(AssetArchiveEntry);
+	for (size_t i = 0; i < assets.size(); ++i) {
+		offset = (offset + ASSET_DATA_ALIGNMENT - 1) / ASSET_DATA_ALIGNMENT * ASSET_DATA_ALIGNMENT;
+		if (offset + assets[i].data.size() > 0xFFFFFFFFu) {
+			fprintf(stderr, "Archive too large\n");
+			return 1;
+		}
+		strcpy(entries[i].name, assets[i].name.c_str());
+		entries[i].offset = (Uint32)offset;
+		entries[i].size = (Uint32)assets[i].data.size();
+		entries[i].hash = HashAssetData(assets[i].data.data(), assets[i].data.size());
+		offset += assets[i].data.size();
+	}
+
+	FILE* file = fopen(archivePath, "wb");
+	if (file == NULL) {
+		fprintf(stderr, "Unable to write %s\n", archivePath);
+		return 1;
+	}
+	bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (!entries.empty()) {
+		isWritten &= fwrite(entries.data(), sizeof(AssetArchiveEntry), entries.size(), file) == entries.size();
+	}
+	const unsigned char padding[ASSET_DATA_ALIGNMENT] = { 0 };
+	for (size_t i = 0; i < assets.size() && isWritten; ++i) {
+		size_t paddingSize = entries[i].offset - (size_t)ftell(file);
+		isWritten &= fwrite(padding, 1, paddingSize, file) == paddingSize;
+		isWritten &= fwrite(assets[i].data.data(), 1, assets[i].data.size(), file) == assets[i].data.size();
+	}
+	isWritten &= fclose(file) == 0;
+	if (!isWritten) {
+		fprintf(stderr, "Unable to write %s\n", archivePath);
+		return 1;
+	}
+
+	printf("%s: %zu assets, %zu bytes\n", archivePath, assets.size(), offset);
+	return 0;
+}
+
+static int List(const char* archivePath) {
+	AssetArchive archive;
+	if (!OpenAssetArchive(archivePath, &archive)) {
+		fprintf(stderr, "Unable to open archive %s\n", archivePath);
+		return 1;
+	}
+
+	int result = 0;
+	for (Uint32 i = 0; i < archive.entryCount; ++i) {
+		const AssetArchiveEntry& entry = archive.entries[i];
+		bool isIntact = HashAssetData(GetAssetData(archive, entry), entry.size) == entry.hash;
+		printf("%-48s offset %10u size %10u hash %016llx%s\n", entry.name, (unsigned int)entry.offset, (unsigned int)entry.size,
+			(unsigned long long)entry.hash, isIntact ? "" : " CORRUPT");
+		if (!isIntact) {
+			result = 1;
+		}
+	}
+
+	CloseAssetArchive(&archive);
+	return result;
+}
+
+int main(int argc, char** argv) {
+	if (argc == 3 && strcmp(argv[1], "--list") == 0) {
+		return List(argv[2]);
+	}
+	if (argc >= 2 && strncmp(argv[1], "--", 2) != 0) {
+		return Pack(argv[1], argc - 2, argv + 2);
+	}
+
+	fprintf(stderr, "usage: asset_packer <archive> <file>...\n       asset_packer --list <archive>\n");
+	return 2;
+}
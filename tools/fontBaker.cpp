@@ -0,0 +1,215 @@
+// Bakes fonts into the blob read by core/bakedFont.h
+// Every face is the printable ASCII range of a font at one point size, rasterized with SDL_ttf.
+// The game looks faces up by size only, so the sizes have to be unique.
+//
+// usage: font_baker <out.bfnt> <font file>:<size>...
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "bakedFont.h"
+
+const int ATLAS_WIDTH = 512;
+const int GLYPH_PADDING = 1; // keeps linear filtering from bleeding into the neighbours
+
+struct RasterizedGlyph {
+	std::vector<unsigned char> coverage; // w * h
+	int w;
+	int h;
+	int offsetX;
+	int offsetY;
+	int advance;
+};
+
+// trims the transparent border of the glyph, offsets are relative to the pen position and the top of the line
+static bool RasterizeGlyph(TTF_Font* font, Uint16 character, RasterizedGlyph* glyph) {
+	int minX, maxX, minY, maxY, advance;
+	if (TTF_GlyphMetrics(font, character, &minX, &maxX, &minY, &maxY, &advance) != 0) {
+		return false;
+	}
+	*glyph = RasterizedGlyph();
+	glyph->advance = advance;
+
+	SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, character, SDL_Color{ 255, 255, 255, 255 });
+	if (rendered == NULL) {
+		// whitespace renders nothing with some SDL_ttf versions
+		return character == ' ';
+	}
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(rendered);
+	if (surface == NULL) {
+		return false;
+	}
+
+	int left = surface->w, right = -1, top = surface->h, bottom = -1;
+	for (int y = 0; y < surface->h; ++y) {
+		const Uint32* pixel = (const Uint32*)((const Uint8*)surface->pixels + y * surface->pitch);
+		for (int x = 0; x < surface->w; ++x) {
+			if ((pixel[x] >> 24) != 0) {
+				left = SDL_min(left, x);
+				right = SDL_max(right, x);
+				top = SDL_min(top, y);
+				bottom = SDL_max(bottom, y);
+			}
+		}
+	}
+
+	if (right >= 0) {
+		glyph->w = right - left + 1;
+		glyph->h = bottom - top + 1;
+		// TTF_RenderGlyph_* draws the glyph at its left bearing when it is positive
+		glyph->offsetX = left + SDL_min(minX, 0);
+		glyph->offsetY = top;
+		glyph->coverage.resize(glyph->w * glyph->h);
+		for (int y = 0; y < glyph->h; ++y) {
+			const Uint32* pixel = (const Uint32*)((const Uint8*)surface->pixels + (top + y) * surface->pitch) + left;
+			for (int x = 0; x < glyph->w; ++x) {
+				glyph->coverage[y * glyph->w + x] = (unsigned char)(pixel[x] >> 24);
+			}
+		}
+	}
+	SDL_FreeSurface(surface);
+	return true;
+}
+
+static bool ParseFaceArgument(const char* argument, std::string* path, int* size) {
+	const char* separator = strrchr(argument, ':');
+	if (separator == NULL) {
+		return false;
+	}
+	char* end;
+	long value = strtol(separator + 1, &end, 10);
+	if (*end != '\0' || value <= 0 || value > 255) {
+		return false;
+	}
+	path->assign(argument, separator);
+	*size = (int)value;
+	return true;
+}
+
+static bool WriteBlob(const char* path, const std::vector<BakedFace>& faces, const std::vector<unsigned char>& atlas, int atlasHeight) {
+	BakedFontHeader header = BakedFontHeader();
+	memcpy(header.magic, BAKED_FONT_MAGIC, sizeof(header.magic));
+	header.version = BAKED_FONT_VERSION;
+	header.faceCount = (Uint16)faces.size();
+	header.atlasWidth = (Uint16)ATLAS_WIDTH;
+	header.atlasHeight = (Uint16)atlasHeight;
+
+	FILE* file = fopen(path, "wb");
+	if (file == NULL) {
+		return false;
+	}
+	bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1;
+	isWritten &= fwrite(faces.data(), sizeof(BakedFace), faces.size(), file) == faces.size();
+	isWritten &= fwrite(atlas.data(), 1, atlas.size(), file) == atlas.size();
+	isWritten &= fclose(file) == 0;
+	return isWritten;
+}
+
+static int Bake(const char* outputPath, int faceCount, char** faceArguments) {
+	std::vector<BakedFace> faces(faceCount, BakedFace());
+	std::vector<unsigned char> atlas;
+
+	// shelf packing: glyphs are placed left to right, a new shelf starts below the tallest glyph of the current one
+	int shelfX = 0, shelfY = 0, shelfHeight = 0;
+	for (int i = 0; i < faceCount; ++i) {
+		std::string fontPath;
+		int size;
+		if (!ParseFaceArgument(faceArguments[i], &fontPath, &size)) {
+			fprintf(stderr, "Expected <font file>:<size>, got %s\n", faceArguments[i]);
+			return 1;
+		}
+		for (int j = 0; j < i; ++j) {
+			if (faces[j].size == size) {
+				fprintf(stderr, "Size %d baked twice, faces are looked up by size\n", size);
+				return 1;
+			}
+		}
+
+		TTF_Font* font = TTF_OpenFont(fontPath.c_str(), size);
+		if (font == NULL) {
+			fprintf(stderr, "Unable to open %s: %s\n", fontPath.c_str(), TTF_GetError());
+			return 1;
+		}
+
+		BakedFace& face = faces[i];
+		face.size = (Uint16)size;
+		face.lineHeight = (Uint16)TTF_FontHeight(font);
+		face.ascent = (Uint16)TTF_FontAscent(font);
+		for (int j = 0; j < BAKED_GLYPH_COUNT; ++j) {
+			RasterizedGlyph glyph;
+			if (!RasterizeGlyph(font, (Uint16)(BAKED_FIRST_GLYPH + j), &glyph)) {
+				fprintf(stderr, "Unable to render '%c' of %s: %s\n", BAKED_FIRST_GLYPH + j, fontPath.c_str(), TTF_GetError());
+				TTF_CloseFont(font);
+				return 1;
+			}
+			if (glyph.w > 255 || glyph.h > 255 || glyph.advance > 255 || glyph.offsetX < -128 || glyph.offsetX > 127 ||
+				glyph.offsetY < -128 || glyph.offsetY > 127) {
+				fprintf(stderr, "Glyph '%c' of %s at size %d is too large to bake\n", BAKED_FIRST_GLYPH + j, fontPath.c_str(), size);
+				TTF_CloseFont(font);
+				return 1;
+			}
+
+			if (shelfX + glyph.w > ATLAS_WIDTH) {
+				shelfX = 0;
+				shelfY += shelfHeight + GLYPH_PADDING;
+				shelfHeight = 0;
+			}
+			if (shelfY + glyph.h > 0xFFFF) {
+				fprintf(stderr, "Atlas too large\n");
+				TTF_CloseFont(font);
+				return 1;
+			}
+			size_t atlasSize = (size_t)(shelfY + glyph.h) * ATLAS_WIDTH;
+			if (atlasSize > atlas.size()) {
+				atlas.resize(atlasSize);
+			}
+			for (int y = 0; y < glyph.h; ++y) {
+				memcpy(&atlas[(shelfY + y) * ATLAS_WIDTH + shelfX], &glyph.coverage[y * glyph.w], glyph.w);
+			}
+
+			BakedGlyph& baked = face.glyphs[j];
+			baked.x = (Uint16)shelfX;
+			baked.y = (Uint16)shelfY;
+			baked.w = (Uint8)glyph.w;
+			baked.h = (Uint8)glyph.h;
+			baked.offsetX = (Sint8)glyph.offsetX;
+			baked.offsetY = (Sint8)glyph.offsetY;
+			baked.advance = (Uint8)glyph.advance;
+			if (glyph.w > 0) {
+				shelfX += glyph.w + GLYPH_PADDING;
+				shelfHeight = SDL_max(shelfHeight, glyph.h);
+			}
+		}
+		TTF_CloseFont(font);
+	}
+
+	int atlasHeight = (int)(atlas.size() / ATLAS_WIDTH);
+	if (!WriteBlob(outputPath, faces, atlas, atlasHeight)) {
+		fprintf(stderr, "Unable to write %s\n", outputPath);
+		return 1;
+	}
+	printf("%s: %d faces, %dx%d atlas\n", outputPath, faceCount, ATLAS_WIDTH, atlasHeight);
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: font_baker <out.bfnt> <font file>:<size>...\n");
+		return 2;
+	}
+	if (TTF_Init() == -1) {
+		fprintf(stderr, "TTF_Init: %s\n", TTF_GetError());
+		return 1;
+	}
+
+	int result = Bake(argv[1], argc - 2, argv + 2);
+	TTF_Quit();
+	return result;
+}
@@ -0,0 +1,220 @@
+// Offline "perfect player" for level design: beam search over paddle inputs.
+// Every search step holds one paddle action (left, stay or right) for --hold frames of TARGET_MILLIS_PER_FRAME
+// game time each, the step the games run with.
+// The children of the whole beam are ranked by score minus --life-penalty points per life lost, ties go to the
+// paddle closest to the ball, and the best --beam distinct ones are kept. The search stops at the first step
+// a child clears the level (--level, counting from 0) and prints the best score and clear time.
+// Games are CompactGame (core/compactGame.h), so cloning a node is a 56 byte copy, and the beam is expanded
+// on --threads threads.
+//
+// usage: level_solver [--seed <n>] [--level <n>] [--beam <width>] [--hold <frames>] [--life-penalty <points>]
+//                     [--max-seconds <game seconds>] [--threads <n>]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compactGame.h"
+
+struct SolverOptions {
+	Uint32 seed;
+	int level;
+	int beamWidth;
+	int holdFrames;
+	int lifePenalty;
+	double maxSeconds;
+	int threadCount;
+};
+
+struct SearchNode {
+	CompactGame game;
+	Uint32 frames; // simulated since the start
+	Sint64 rank; // higher is better
+	bool isValid; // false for children of finished games
+};
+
+static bool IsLevelCleared(const CompactGame& game, const SolverOptions& options) {
+	return game.level != options.level;
+}
+
+const float SOLVER_TIME_DELTA = TARGET_MILLIS_PER_FRAME / (float)1000;
+const int ACTION_COUNT = 3; // left, stay, right
+
+// game time simulated by that many frames
+static double GetGameSeconds(Uint32 frames) {
+	return frames * TARGET_MILLIS_PER_FRAME / 1000.0;
+}
+
+static Sint64 RankGame(const CompactGame& game, int lifePenalty) {
+	int value = game.score - lifePenalty * (STARTING_LIVES - game.lives);
+	int distance = abs(game.paddleX + PADDLE_WIDTH / 2 - (game.ballX + BALL_WIDTH / 2));
+	return (Sint64)value * 4096 - SDL_min(distance, 4095);
+}
+
+// orders by rank and then by every field, so equal games end up next to each other
+static bool IsRankedBefore(const SearchNode& a, const SearchNode& b) {
+	if (a.rank != b.rank) {
+		return a.rank > b.rank;
+	}
+	int order = CompareCompactGames(a.game, b.game);
+	if (order != 0) {
+		return order < 0;
+	}
+	return a.frames < b.frames;
+}
+
+// children of beam[first, last), ACTION_COUNT each
+static void ExpandNodes(const std::vector<SearchNode>& beam, size_t first, size_t last, const SolverOptions& options, SearchNode* children) {
+	for (size_t i = first; i < last; ++i) {
+		const SearchNode& parent = beam[i];
+		for (int action = 0; action < ACTION_COUNT; ++action) {
+			SearchNode& child = children[i * ACTION_COUNT + action];
+			child = parent;
+			child.isValid = !parent.game.isGameOver && !IsLevelCleared(parent.game, options);
+			if (!child.isValid) {
+				continue;
+			}
+
+			float travel = (action - 1) * SOLVER_TIME_DELTA;
+			for (int frame = 0; frame < options.holdFrames && !child.game.isGameOver && !IsLevelCleared(child.game, options); ++frame) {
+				StepCompactGame(&child.game, travel, SOLVER_TIME_DELTA);
+				++child.frames;
+			}
+			child.rank = RankGame(child.game, options.lifePenalty);
+		}
+	}
+}
+
+static void PrintUsage() {
+	fprintf(stderr, "usage: level_solver [--seed <n>] [--level <n>] [--beam <width>] [--hold <frames>] [--life-penalty <points>] "
+		"[--max-seconds <game seconds>] [--threads <n>]\n");
+}
+
+static bool ParseOptions(int argc, char** argv, SolverOptions* options) {
+	options->seed = 1;
+	options->level = 0;
+	options->beamWidth = 1024;
+	options->holdFrames = 8;
+	// more than the whole board is worth, so no life is given up for points
+	options->lifePenalty = 1000;
+	options->maxSeconds = 600.0;
+	options->threadCount = (int)SDL_max(1u, std::thread::hardware_concurrency());
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (i + 1 >= argc) {
+			return false;
+		}
+		if (arg == "--seed") {
+			options->seed = (Uint32)strtoul(argv[++i], NULL, 10);
+		}
+		else if (arg == "--level") {
+			options->level = atoi(argv[++i]);
+		}
+		else if (arg == "--beam") {
+			options->beamWidth = atoi(argv[++i]);
+		}
+		else if (arg == "--hold") {
+			options->holdFrames = atoi(argv[++i]);
+		}
+		else if (arg == "--life-penalty") {
+			options->lifePenalty = atoi(argv[++i]);
+		}
+		else if (arg == "--max-seconds") {
+			options->maxSeconds = atof(argv[++i]);
+		}
+		else if (arg == "--threads") {
+			options->threadCount = atoi(argv[++i]);
+		}
+		else {
+			return false;
+		}
+	}
+	// seed 0 would make the games use rand()
+	return options->seed != 0 && options->level >= 0 && options->level < 255 && options->beamWidth > 0 && options->holdFrames > 0 && options->lifePenalty >= 0 &&
+		options->maxSeconds > 0.0 && options->threadCount > 0;
+}
+
+int main(int argc, char** argv) {
+	SolverOptions options;
+	if (!ParseOptions(argc, argv, &options)) {
+		PrintUsage();
+		return 2;
+	}
+
+	GameState state;
+	InitSeededGame(&state, options.seed);
+	// not in CompactGame
+	state.arePowerUpsEnabled = false;
+	StartLevel(&state, options.level);
+	SearchNode root = SearchNode();
+	PackGame(state, &root.game);
+	root.rank = RankGame(root.game, options.lifePenalty);
+	root.isValid = true;
+
+	std::vector<SearchNode> beam(1, root);
+	std::vector<SearchNode> children;
+	children.reserve((size_t)options.beamWidth * ACTION_COUNT);
+	SearchNode best = root;
+	bool isCleared = false;
+	Uint64 nodeCount = 0;
+	Uint64 stepCount = 0;
+	Uint32 maxFrames = (Uint32)(options.maxSeconds * 1000 / TARGET_MILLIS_PER_FRAME);
+
+	std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+	while (!beam.empty() && !isCleared && beam[0].frames < maxFrames) {
+		children.resize(beam.size() * ACTION_COUNT);
+		int threads = (int)SDL_min((size_t)options.threadCount, beam.size());
+		std::vector<std::thread> workers;
+		for (int t = 1; t < threads; ++t) {
+			workers.emplace_back(ExpandNodes, std::cref(beam), beam.size() * t / threads, beam.size() * (t + 1) / threads,
+				std::cref(options), children.data());
+		}
+		ExpandNodes(beam, 0, beam.size() / threads, options, children.data());
+		for (size_t t = 0; t < workers.size(); ++t) {
+			workers[t].join();
+		}
+
+		children.erase(std::remove_if(children.begin(), children.end(), [](const SearchNode& node) { return !node.isValid; }), children.end());
+		for (size_t i = 0; i < children.size(); ++i) {
+			const SearchNode& child = children[i];
+			nodeCount += 1;
+			stepCount += child.frames - beam[0].frames;
+			bool isChildCleared = IsLevelCleared(child.game, options);
+			// a clear beats everything, then the score (less lost lives) and the time it took
+			if ((isChildCleared && !isCleared) || (isChildCleared == isCleared &&
+				(child.rank / 4096 > best.rank / 4096 || (child.rank / 4096 == best.rank / 4096 && child.frames < best.frames)))) {
+				best = child;
+				isCleared = isChildCleared;
+			}
+		}
+
+		std::sort(children.begin(), children.end(), IsRankedBefore);
+		beam.clear();
+		for (size_t i = 0; i < children.size() && beam.size() < (size_t)options.beamWidth; ++i) {
+			if (children[i].game.isGameOver || (!beam.empty() && CompareCompactGames(children[i].game, beam.back().game) == 0)) {
+				continue;
+			}
+			beam.push_back(children[i]);
+		}
+	}
+	double searchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+
+	printf("seed %u, level %d, beam %d, hold %d frames\n", options.seed, options.level, options.beamWidth, options.holdFrames);
+	if (isCleared) {
+		printf("cleared in %.2f s (%u frames), score %d, lives lost %d\n", GetGameSeconds(best.frames), best.frames,
+			best.game.score, STARTING_LIVES - best.game.lives);
+	}
+	else {
+		printf("not cleared within %.0f s, best score %d after %.2f s, lives lost %d\n", options.maxSeconds, best.game.score,
+			GetGameSeconds(best.frames), STARTING_LIVES - best.game.lives);
+	}
+	printf("%llu nodes, %llu steps in %.2f s on %d threads: %.2fM nodes/s, %.2fM steps/s\n", (unsigned long long)nodeCount,
+		(unsigned long long)stepCount, searchSeconds, options.threadCount, nodeCount / searchSeconds / 1e6, stepCount / searchSeconds / 1e6);
+	return isCleared ? 0 : 1;
+}
@@ -1,6 +1,5 @@
 #include <iostream>
 #include <stdio.h>
-#include <unordered_map>
 #include <string>
 #include <stdlib.h>
 #include <time.h>
@@ -8,98 +7,16 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
-// PS VITA SCREEN DIMENSIONS
-const int SCREEN_WIDTH = 960;
-const int SCREEN_HEIGHT = 544;
-
-const int TARGET_FRAME_RATE = 60;
-const int TARGET_MILLIS_PER_FRAME = ((float)1 / TARGET_FRAME_RATE) * 1000;
-
-const int STARTING_LIVES = 3;
-// measured in meters per second
-const int BALL_SPEED = 250;
-
-const int BRICKS_PER_LAYER = 13;
-const int LAYERS = 8;
-const int BRICKS_COUNT = BRICKS_PER_LAYER * LAYERS;
-const int BRICK_WIDTH = 70;
-const int BRICK_HEIGHT = 15;
-const int BRICK_HORIZ_PADDING = 3;
-const int BRICK_VERT_PADDING = 5;
-const int CEILING_OFFSET = 30;
-
-const SDL_Color CYAN { 0, 255, 255, 255 };
-const SDL_Color PURPLE { 128, 0, 128, 255 };
-const SDL_Color BLUE { 0, 0, 255, 255 };
-const SDL_Color GREEN { 0, 255, 0, 255 };
-const SDL_Color YELLOW { 255, 255, 0, 255 };
-const SDL_Color ORANGE{ 255, 165, 0, 255 };
-const SDL_Color RED { 255, 0, 0, 255 };
-const SDL_Color PINK{ 255, 192, 203, 255 };
-
-const SDL_Color BRICK_COLORS[LAYERS] { PINK, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, CYAN };
-
-enum class ColorLabel {
-	PINK = 0, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, CYAN
-};
-
-void initBrickPositions(SDL_Rect* bricks, int layerCount, int bricksPerLayer, int width, int height, int horizPadding, int vertPadding) {
-	for (int i = 0; i < layerCount; ++i) {
-		for (int j = 0; j < bricksPerLayer; ++j) {
-			bricks[i * bricksPerLayer + j] = { 
-				(j * (width + horizPadding)) + 6, 
-				(i * (height + vertPadding)) + vertPadding + CEILING_OFFSET, 
-				width, 
-				height 
-			};
-		}
-	}
-}
-
-void drawBricks(SDL_Renderer* renderer, SDL_Rect* bricks,bool* bricksCollisionMap, const SDL_Color colors[], int layerCount, int bricksPerLayer) {
-	for (int i = 0; i < layerCount; ++i) {
-		SDL_SetRenderDrawColor(renderer, colors[i].r, colors[i].g, colors[i].b, colors[i].a);
-		for (int j = 0; j < bricksPerLayer; ++j) {
-			if (!bricksCollisionMap[i * bricksPerLayer + j]) {
-				SDL_RenderFillRect(renderer, &bricks[i * bricksPerLayer + j]);
-			}
-		}
-	}
-}
-
-bool canRectanglesOverlap(const SDL_Rect& r1, const SDL_Rect& r2) {
-	return (
-		// Horizontal component
-		r1.x < r2.x + r2.w && r1.x + r1.w > r2.x &&
-		// Vertical component
-		r1.y < r2.y + r2.h && r1.y + r1.h > r2.y
-	);
-}
-
-int checkBrickCollision(SDL_Rect* bricks, bool* bricksCollisionMap, int bricksCount, const SDL_Rect& ball, float xVel, float yVel) {
-	for (int i = 0; i < bricksCount; ++i) {
-		// skip to the next brick if a collision already happened
-		if (bricksCollisionMap[i]) {
-			continue;
-		}
-
-		// Needs improvement: (Ball moving diagonally will sometimes will fail the collision detection
-		// check and cause the ball to go through the next set of bricks above the brick we just hit)
-		// Collision detection can be more accurate by calculating
-		// the point of intersection between a projected point and edge of a brick
-		// What can I do with point of intersection?
-		// Can correct the position of the brick (1 frame) so that it doesn't pass over bricks
-		// it should have not hit in the upcoming frames by setting the ball's position to
-		// the point of intersection
-		// See: https://codeincomplete.com/articles/collision-detection-in-breakout/
-		if (canRectanglesOverlap(ball, bricks[i])) {
-			bricksCollisionMap[i] = true;
-			return i;
-		}
-	}
-
-	return -1;
-}
+#include "allocationCounter.h"
+#include "assetLoader.h"
+#include "autopilot.h"
+#include "framePacer.h"
+#include "frameProfiler.h"
+#include "game.h"
+#include "gameRenderer.h"
+#include "inputScript.h"
+#include "latencyProbe.h"
+#include "renderScaler.h"
 
 std::string getResourcePath(const std::string& subDir = "") {
 	// We need to choose the path separator properly based on which
@@ -136,54 +53,120 @@ std::string getResourcePath(const std::string& subDir = "") {
 	return subDir.empty() ? baseRes : baseRes + subDir + PATH_SEP;
 }
 
-void ResetBallPosition(SDL_Rect* ball) {
-	ball->x = (SCREEN_WIDTH - ball->w) / 2;
-	ball->y = (SCREEN_HEIGHT - ball->h) / 2;
-}
+// Tracks how long a key was held down inside the current frame window using the
+// timestamps of its press/release events instead of its state at polling time.
+// All times are measured in microseconds
+struct HeldKey {
+	bool isDown;
+	Uint64 downSince;
+	Uint64 heldTime;
+};
+
+void PressKey(HeldKey* key, Uint64 timestamp, Uint64 windowStart) {
+	if (key->isDown) {
+		return;
+	}
 
-void SetRandomBallDirection(int* xDir, int* yDir) {
-	int directions[2] = { -1, 1 };
-	*xDir = directions[rand() % 2];
-	*yDir = 1;
+	key->isDown = true;
+	key->downSince = timestamp > windowStart ? timestamp : windowStart;
 }
 
-void ResetGame(int* score, int* lives, bool* isGameOver, SDL_Rect* ball, int* xDir, int* yDir) {
-	*score = 0;
-	*lives = STARTING_LIVES;
-	*isGameOver = false;
+void ReleaseKey(HeldKey* key, Uint64 timestamp, Uint64 windowStart) {
+	if (!key->isDown) {
+		return;
+	}
 
-	ResetBallPosition(ball);
-	SetRandomBallDirection(xDir, yDir);
+	Uint64 since = key->downSince > windowStart ? key->downSince : windowStart;
+	if (timestamp > since) {
+		key->heldTime += timestamp - since;
+	}
+	key->isDown = false;
 }
 
-void ResetBrickMap(bool* bricks) {
-	for (int i = 0; i < BRICKS_COUNT; ++i) {
-		bricks[i] = false;
+// returns the time the key was held between windowStart and windowEnd and starts a new window
+Uint64 TakeHeldTime(HeldKey* key, Uint64 windowStart, Uint64 windowEnd) {
+	if (key->isDown) {
+		Uint64 since = key->downSince > windowStart ? key->downSince : windowStart;
+		if (windowEnd > since) {
+			key->heldTime += windowEnd - since;
+		}
+		key->downSince = windowEnd;
 	}
-}
 
-void ResetPaddlePosition(SDL_Rect* paddle) {
-	paddle->x = (SCREEN_WIDTH - paddle->w) / 2;
+	Uint64 heldTime = key->heldTime;
+	key->heldTime = 0;
+	return heldTime;
 }
 
 int main(int argc, char** argv) {
+	Uint64 launchedAt = SDL_GetPerformanceCounter();
 
 	// generate random seed based on time
-	srand(time(NULL));
-
-	int currentLives = STARTING_LIVES;
-	int currentScore = 0;
-
-	std::unordered_map<ColorLabel, int> scoresTable;
-	scoresTable[ColorLabel::PINK] = 8;
-	scoresTable[ColorLabel::RED] = 7;
-	scoresTable[ColorLabel::ORANGE] = 6;
-	scoresTable[ColorLabel::YELLOW] = 5;
-	scoresTable[ColorLabel::GREEN] = 4;
-	scoresTable[ColorLabel::BLUE] = 3;
-	scoresTable[ColorLabel::PURPLE] = 2;
-	scoresTable[ColorLabel::CYAN] = 1;
-	
+	unsigned int seed = (unsigned int)time(NULL);
+	srand(seed);
+
+	LatencyProbe latencyProbe;
+	InitLatencyProbe(&latencyProbe, false);
+	// --record <file> saves the session so it can be replayed by the frame harness
+	InputRecorder recorder{ NULL };
+	// --autopilot plays by itself (attract mode), the keyboard only pauses and quits
+	bool isAutopilot = false;
+	// --render-scale <0.25 to 1> draws fewer pixels than the window has and stretches them over it
+	float renderScale = 1.0f;
+	// --present <auto|vsync|paced|uncapped> picks what paces the frames, auto uses vsync when the display has it
+	PresentMode presentMode = PresentMode::AUTO;
+	// --benchmark <frames> runs that many frames as fast as it can, played by the autopilot or by the inputs of
+	// --replay <session> (looped), then prints the throughput and quits
+	Uint32 benchmarkFrames = 0;
+	const char* replayPath = NULL;
+	for (int i = 1; i < argc; ++i) {
+		if (std::string(argv[i]) == "--measure-latency") {
+			latencyProbe.isEnabled = true;
+		}
+		else if (std::string(argv[i]) == "--autopilot") {
+			isAutopilot = true;
+		}
+		else if (std::string(argv[i]) == "--render-scale" && i + 1 < argc) {
+			renderScale = (float)atof(argv[++i]);
+		}
+		else if (std::string(argv[i]) == "--present" && i + 1 < argc) {
+			if (!ParsePresentMode(argv[++i], &presentMode)) {
+				std::cout << "Unknown present mode " << argv[i] << ", use auto, vsync, paced or uncapped" << std::endl;
+			}
+		}
+		else if (std::string(argv[i]) == "--benchmark" && i + 1 < argc) {
+			int frames = atoi(argv[++i]);
+			benchmarkFrames = frames > 0 ? (Uint32)frames : 0;
+		}
+		else if (std::string(argv[i]) == "--replay" && i + 1 < argc) {
+			replayPath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--record" && i + 1 < argc) {
+			const char* sessionPath = argv[++i];
+			if (!BeginRecording(&recorder, sessionPath, seed)) {
+				std::cout << "Unable to record session to " << sessionPath << std::endl;
+			}
+		}
+	}
+
+	InputScript script;
+	if (replayPath != NULL && (!LoadInputScript(replayPath, &script) || script.frames.empty()))
+	{
+		std::cout << "Unable to load session: " << replayPath << std::endl;
+		return 0;
+	}
+
+	bool isBenchmark = benchmarkFrames > 0;
+	if (isBenchmark)
+	{
+		// same game every run, nothing waits for the display
+		seed = replayPath != NULL ? script.seed : 1;
+		isAutopilot = replayPath == NULL;
+		presentMode = PresentMode::UNCAPPED;
+		// counts SDL's allocations too, so it has to be installed before SDL allocates anything
+		InstallAllocationCounter();
+	}
+
 	if (SDL_Init(SDL_INIT_VIDEO) != 0)
 	{
 		std::cout << "Error Initializing SDL: " << SDL_GetError() << std::endl;
@@ -207,116 +190,109 @@ int main(int argc, char** argv) {
 
 	const std::string resourcePath(getResourcePath());
 	std::cout << "BASE PATH: " << resourcePath << std::endl;
-	std::string fontPath(resourcePath + "font.otf");
-	TTF_Font* font = TTF_OpenFont(fontPath.c_str(), 28);
-	if (font == nullptr) {
-		std::cout << "Unable to load font: " << TTF_GetError() << std::endl;
-		int num;
-		std::cin >> num;
-		return 0;
-	}
-
-	TTF_Font* bigFont = TTF_OpenFont(fontPath.c_str(), 48);
-	if (bigFont == nullptr) {
-		std::cout << "Unable to load font: " << TTF_GetError() << std::endl;
-		int num;
-		std::cin >> num;
-		return 0;
-	}
+	std::string archivePath(resourcePath + "assets.pak");
+	// fonts and labels are loaded while the window and renderer are created, the first frames are drawn without the UI
+	AssetLoader assets;
+	StartAssetLoader(&assets, archivePath.c_str(), "fonts.bfnt", "font.otf", 28, "font.otf", 48, "Press Spacebar to Play Again", "Press P to Unpause");
 
 	SDL_Window* window = SDL_CreateWindow(
 		"Breakout Clone",
 		SDL_WINDOWPOS_CENTERED,
 		SDL_WINDOWPOS_CENTERED,
-		SCREEN_WIDTH,
-		SCREEN_HEIGHT,
-		SDL_WINDOW_SHOWN
+		GAME_WIDTH,
+		GAME_HEIGHT,
+		SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
 	);
 
-	SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-
-	int paddleWidth = 150;
-	int paddleHeight = 20;
-	int paddleSpeed = 1000;
-	SDL_Rect paddle { (SCREEN_WIDTH - paddleWidth) / 2, (SCREEN_HEIGHT - paddleHeight) - 20, paddleWidth, paddleHeight };
+	SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | GetPresentRendererFlags(presentMode));
+	if (renderer == NULL)
+	{
+		// e.g. SDL's dummy video driver only has the software renderer
+		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+	}
+	if (renderer == NULL)
+	{
+		std::cout << "Error creating the renderer: " << SDL_GetError() << std::endl;
+		return 0;
+	}
 
-	int ballWidth = 15;
-	int ballHeight = 15;
-	// measured in units per second
-	int ballSpeed = BALL_SPEED;
-	int xDirection;
-	int yDirection;
+	FramePacer pacer;
+	InitFramePacer(&pacer, renderer, presentMode);
+	std::cout << "presenting " << GetPresentModeName(pacer.mode) << ", " << pacer.refreshMillis << " ms refresh" << std::endl;
 
-	SetRandomBallDirection(&xDirection, &yDirection);
-	SDL_Rect ball{ (SCREEN_WIDTH - ballWidth) / 2, (SCREEN_HEIGHT - ballHeight) / 2, ballWidth, ballHeight };
+	// the game keeps its logical size whatever the window's size in pixels
+	RenderScaler scaler;
+	if (!InitRenderScaler(&scaler, renderer, renderScale))
+	{
+		std::cout << "Unable to scale the rendering: " << SDL_GetError() << std::endl;
+	}
+	std::cout << "rendering " << (scaler.target ? scaler.targetWidth : scaler.outputWidth) << "x"
+		<< (scaler.target ? scaler.targetHeight : scaler.outputHeight) << " for a " << scaler.outputWidth << "x" << scaler.outputHeight << " window" << std::endl;
 
-	SDL_Rect bricks[BRICKS_COUNT];
-	initBrickPositions(bricks, LAYERS, BRICKS_PER_LAYER, BRICK_WIDTH, BRICK_HEIGHT, BRICK_HORIZ_PADDING, BRICK_VERT_PADDING);
+	GameState game;
+	InitGame(&game);
 
-	bool bricksCollisionMap[BRICKS_COUNT];
-	for (int i = 0; i < BRICKS_COUNT; ++i) {
-		bricksCollisionMap[i] = false;
-	}
+	GameLabels labels;
+	bool areAssetsLoaded = false;
+	bool isFirstFrame = true;
 
-	SDL_Color textColor{ 255, 255, 255, 255 };
-	SDL_Surface* surf = TTF_RenderText_Solid(font, "Score: ", textColor);
-	SDL_Texture* scoreLabelTexture = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_Rect scoreLabelRect{ 0, 0, 0, 0 };
-	SDL_QueryTexture(scoreLabelTexture, NULL, NULL, &(scoreLabelRect.w), &(scoreLabelRect.h));
-	SDL_FreeSurface(surf);
-
-	surf = TTF_RenderText_Solid(font, "Lives: ", textColor);
-	SDL_Texture* livesLabelTexture = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_Rect livesLabelRect{ 0, 0, 0, 0 };
-	SDL_QueryTexture(livesLabelTexture, NULL, NULL, &(livesLabelRect.w), &(livesLabelRect.h));
-	SDL_FreeSurface(surf);
-
-	surf = TTF_RenderText_Solid(bigFont, "Game Over", textColor);
-	SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_Rect gameOverRect{ 0, 0, 0, 0 };
-	SDL_QueryTexture(gameOverTexture, NULL, NULL, &(gameOverRect.w), &(gameOverRect.h));
-	SDL_FreeSurface(surf);
-	gameOverRect.x = (SCREEN_WIDTH - gameOverRect.w) / 2;
-	gameOverRect.y = (SCREEN_HEIGHT - gameOverRect.h) / 2;
-
-	surf = TTF_RenderText_Solid(bigFont, "Press Spacebar to Play Again", textColor);
-	SDL_Texture* playAgainTexture = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_Rect playAgainRect{ 0, 0, 0, 0 };
-	SDL_QueryTexture(playAgainTexture, NULL, NULL, &(playAgainRect.w), &(playAgainRect.h));
-	SDL_FreeSurface(surf);
-	playAgainRect.x = (SCREEN_WIDTH - playAgainRect.w) / 2;
-	playAgainRect.y = (SCREEN_HEIGHT + gameOverRect.h + 100 - playAgainRect.h) / 2;
-
-	surf = TTF_RenderText_Solid(bigFont, "Game Paused", textColor);
-	SDL_Texture* gamePauseTexture = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_Rect gamePauseRect{ 0, 0, 0, 0 };
-	SDL_QueryTexture(gamePauseTexture, NULL, NULL, &(gamePauseRect.w), &(gamePauseRect.h));
-	SDL_FreeSurface(surf);
-	gamePauseRect.x = (SCREEN_WIDTH - gamePauseRect.w) / 2;
-	gamePauseRect.y = (SCREEN_HEIGHT - gamePauseRect.y) / 2;
-
-	surf = TTF_RenderText_Solid(bigFont, "Press P to Unpause", textColor);
-	SDL_Texture* pauseLabelTexture = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_Rect pauseLabelRect{ 0, 0, 0, 0 };
-	SDL_QueryTexture(pauseLabelTexture, NULL, NULL, &(pauseLabelRect.w), &(pauseLabelRect.h));
-	SDL_FreeSurface(surf);
-	pauseLabelRect.x = (SCREEN_WIDTH - pauseLabelRect.w) / 2;
-	pauseLabelRect.y = (SCREEN_HEIGHT + gamePauseRect.h + 100 - pauseLabelRect.h) / 2;
-
-	bool leftPressed = false;
-	bool rightPressed = false;
+	HeldKey leftKey{ false, 0, 0 };
+	HeldKey rightKey{ false, 0, 0 };
+	// start of the window the paddle input is integrated over (microseconds)
+	Uint64 inputWindowStart = SDL_GetTicks() * (Uint64)1000;
 
 	// measured in 1 / X seconds
 	float timeDelta = (TARGET_MILLIS_PER_FRAME / (float)1000);
 	std::cout << "time delta: " << timeDelta << std::endl;
 
-	bool isGameOver = false;
-	bool isGamePaused = false;
+	FrameProfiler profiler;
+	bool isMeasuring = false;
+	size_t replayFrame = 0;
+	if (isBenchmark)
+	{
+		InitFrameProfiler(&profiler, benchmarkFrames);
+	}
+
+	GameInput pendingInput{ 0.0f, false, false };
 	bool isGameRunning = true;
 
 	while (isGameRunning)
 	{
-		Uint32 start = SDL_GetTicks();
+		if (!areAssetsLoaded)
+		{
+			AssetLoadState assetState = PollAssetLoader(&assets, renderer, &labels);
+			if (assetState == ASSETS_FAILED)
+			{
+				std::cout << "Unable to load font: " << assets.error << std::endl;
+				break;
+			}
+			areAssetsLoaded = assetState == ASSETS_READY;
+			if (areAssetsLoaded)
+			{
+				std::cout << "assets loaded " << (assets.isFromArchive ? "from the archive" : "from files")
+					<< (assets.font.baked ? " with baked fonts" : " with TTF fonts") << " in " << GetAssetLoadMillis(assets) << " ms, ready "
+					<< (SDL_GetPerformanceCounter() - launchedAt) * 1000.0 / SDL_GetPerformanceFrequency() << " ms after launch" << std::endl;
+			}
+		}
+
+		if (isBenchmark && areAssetsLoaded && !isMeasuring)
+		{
+			// the measured frames start from a new game with everything loaded
+			isMeasuring = true;
+			srand(seed);
+			InitGame(&game);
+			gRenderStats = RenderStats();
+			std::cout << "benchmark: " << benchmarkFrames << " frames " << (replayPath != NULL ? "replaying " : "with the autopilot")
+				<< (replayPath != NULL ? replayPath : "") << " using the " << SDL_GetCurrentVideoDriver() << " video driver" << std::endl;
+		}
+
+		BeginPacedFrame(&pacer);
+		if (isMeasuring)
+		{
+			BeginFrame(&profiler);
+		}
+		Uint64 inputWindowEnd = SDL_GetTicks() * (Uint64)1000;
+		GameInput input{ 0.0f, false, false };
 
 		SDL_Event e;
 		while(SDL_PollEvent(&e) > 0)
@@ -326,190 +302,162 @@ int main(int argc, char** argv) {
 				SDL_Log("Qutting game at %i timestamp", e.quit.timestamp);
 				isGameRunning = false;
 			}
-			// For 1 frame movement feels like it stalls then it continues moving smoothly afterwards
+			else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+			{
+				UpdateRenderScaler(&scaler, renderer, scaler.renderScale);
+			}
+			// Paddle movement is integrated over the exact press/release times of the key events
+			// so it no longer stalls for 1 frame waiting on the next poll
 			else if (e.type == SDL_KEYDOWN)
 			{
+				if (!e.key.repeat)
+				{
+					RecordInputEvent(&latencyProbe, e.key.timestamp * (Uint64)1000);
+				}
+
 				if (e.key.keysym.sym == SDL_KeyCode::SDLK_LEFT)
 				{
-					//std::cout << "left pressed" << std::endl;
-					leftPressed = true;
+					PressKey(&leftKey, e.key.timestamp * (Uint64)1000, inputWindowStart);
 				}
 				else if (e.key.keysym.sym == SDL_KeyCode::SDLK_RIGHT)
 				{
-					//std::cout << "right pressed" << std::endl;
-					rightPressed = true;
+					PressKey(&rightKey, e.key.timestamp * (Uint64)1000, inputWindowStart);
 				}
 
-				if (isGameOver && e.key.keysym.sym == SDL_KeyCode::SDLK_SPACE)
+				if (e.key.keysym.sym == SDL_KeyCode::SDLK_SPACE)
 				{
-					ResetGame(&currentScore, &currentLives, &isGameOver, &ball, &xDirection, &yDirection);
-					ResetPaddlePosition(&paddle);
-					ResetBrickMap(bricksCollisionMap);
+					input.restart = true;
 				}
 
 				// toggle pause
-				if (!isGameOver && e.key.keysym.sym == SDL_KeyCode::SDLK_p)
+				if (e.key.keysym.sym == SDL_KeyCode::SDLK_p)
 				{
-					isGamePaused = !isGamePaused;
+					input.togglePause = !input.togglePause;
 				}
 			}
 			else if (e.type == SDL_KEYUP)
 			{
 				if (e.key.keysym.sym == SDL_KeyCode::SDLK_LEFT)
 				{
-					//std::cout << "left released" << std::endl;
-					leftPressed = false;
+					ReleaseKey(&leftKey, e.key.timestamp * (Uint64)1000, inputWindowStart);
 				}
 				else if (e.key.keysym.sym == SDL_KeyCode::SDLK_RIGHT)
 				{
-					//std::cout << "right released" << std::endl;
-					rightPressed = false;
+					ReleaseKey(&rightKey, e.key.timestamp * (Uint64)1000, inputWindowStart);
 				}
 			}
 		}
 
-		float xVel = xDirection * ballSpeed * timeDelta;
-		float yVel = yDirection * ballSpeed * timeDelta;
-
-		// Screen Bounds Ball Collision Check
+		Uint64 leftHeld = TakeHeldTime(&leftKey, inputWindowStart, inputWindowEnd);
+		Uint64 rightHeld = TakeHeldTime(&rightKey, inputWindowStart, inputWindowEnd);
+		inputWindowStart = inputWindowEnd;
+		input.paddleTravel = ((float)rightHeld - (float)leftHeld) / 1000000;
+		if (isAutopilot)
 		{
-			if (ball.x + xVel < 0)
-			{
-				xDirection *= -1;
-			}
-
-			if (ball.x + ball.w + xVel > SCREEN_WIDTH)
-			{
-				xDirection *= -1;
-			}
-
-			if (ball.y + ball.h + yVel > SCREEN_HEIGHT)
-			{
-				if (currentLives - 1 >= 0) {
-					--currentLives;
-				}
-
-				if (currentLives > 0) {
-					SetRandomBallDirection(&xDirection, &yDirection);
-					ResetBallPosition(&ball);
-				}
-				else {
-					isGameOver = true;
-				}
-			}
-
-			if (ball.y + yVel < CEILING_OFFSET)
-			{
-				yDirection *= -1;
-			}
+			GameInput autopilotInput = GetAutopilotInput(game, timeDelta);
+			input.paddleTravel = autopilotInput.paddleTravel;
+			input.restart = autopilotInput.restart;
 		}
-
-		// Ball to Paddle Collision Check
+		if (isMeasuring && replayPath != NULL)
 		{
-			if (canRectanglesOverlap(ball, paddle)) {
-				yDirection *= -1;
+			if (replayFrame == script.frames.size())
+			{
+				srand(script.seed);
+				InitGame(&game);
+				replayFrame = 0;
 			}
+			input = script.frames[replayFrame].input;
+			timeDelta = script.frames[replayFrame].timeDelta;
+			++replayFrame;
 		}
-
-		int brickIndex = checkBrickCollision(bricks, bricksCollisionMap, BRICKS_COUNT, ball, xVel, yVel);
-		if (brickIndex != -1) {
-			yDirection *= -1;
-			// update score
-			int layerIndex = brickIndex / BRICKS_PER_LAYER;
-			currentScore += scoresTable[(ColorLabel)layerIndex];
+		if (isMeasuring)
+		{
+			EndPhase(&profiler, PHASE_INPUT);
 		}
 
-		// Move Objects
+		// with vsync a frame runs zero or more steps (see FramePacer), input read meanwhile carries over to the next step
+		pendingInput.paddleTravel = isAutopilot ? input.paddleTravel : pendingInput.paddleTravel + input.paddleTravel;
+		pendingInput.togglePause = pendingInput.togglePause != input.togglePause;
+		pendingInput.restart = pendingInput.restart || input.restart;
+		for (int step = 0; step < pacer.steps; ++step)
 		{
-			if (!isGameOver && !isGamePaused) {
-				if (leftPressed)
-				{
-					paddle.x -= paddleSpeed * timeDelta;
-				}
-				else if (rightPressed)
-				{
-					paddle.x += paddleSpeed * timeDelta;
-				}
-			}
-
-			if (!isGamePaused) {
-				ball.x += xDirection * ballSpeed * timeDelta;
-				ball.y += yDirection * ballSpeed * timeDelta;
+			if (isAutopilot && step > 0)
+			{
+				pendingInput = GetAutopilotInput(game, timeDelta);
 			}
+			RecordFrame(&recorder, timeDelta, pendingInput);
+			StepGame(&game, pendingInput, timeDelta);
+			pendingInput = GameInput{ 0.0f, false, false };
 		}
-
-		// RENDER UI
+		if (isMeasuring)
 		{
-			surf = TTF_RenderText_Solid(font, std::to_string(currentScore).c_str(), textColor);
-			SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(renderer, surf);
-			SDL_Rect scoreRect{ 0, 0, 0, 0 };
-			SDL_QueryTexture(scoreTexture, NULL, NULL, &(scoreRect.w), &(scoreRect.h));
-			SDL_FreeSurface(surf);
-
-			surf = TTF_RenderText_Solid(font, std::to_string(currentLives).c_str(), textColor);
-			SDL_Texture* livesTexture = SDL_CreateTextureFromSurface(renderer, surf);
-			SDL_Rect livesRect{ 0, 0, 0, 0 };
-			SDL_QueryTexture(livesTexture, NULL, NULL, &(livesRect.w), &(livesRect.h));
-			SDL_FreeSurface(surf);
-
-			scoreRect.x = scoreLabelRect.x + scoreLabelRect.w;
-			livesRect.x = SCREEN_WIDTH - livesRect.w;
-			livesLabelRect.x = SCREEN_WIDTH - livesLabelRect.w - livesRect.w;
-
-			if (isGameOver) {
-				SDL_RenderCopy(renderer, gameOverTexture, NULL, &gameOverRect);
-				SDL_RenderCopy(renderer, playAgainTexture, NULL, &playAgainRect);
-			}
+			EndPhase(&profiler, PHASE_SIMULATE);
+		}
 
-			if (isGamePaused) {
-				SDL_RenderCopy(renderer, gamePauseTexture, NULL, &gamePauseRect);
-				SDL_RenderCopy(renderer, pauseLabelTexture, NULL, &pauseLabelRect);
-			}
+		BeginScaledFrame(scaler, renderer);
 
-			SDL_RenderCopy(renderer, scoreLabelTexture, NULL, &scoreLabelRect);
-			SDL_RenderCopy(renderer, livesLabelTexture, NULL, &livesLabelRect);
-			SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreRect);
-			SDL_RenderCopy(renderer, livesTexture, NULL, &livesRect);
+		// RENDER UI, placeholder frames without it until the assets are loaded
+		if (areAssetsLoaded)
+		{
+			DrawUI(renderer, &labels, assets.font, game);
 		}
 
 		// Render updates
+		DrawGame(renderer, game);
+		EndScaledFrame(scaler, renderer);
+		DrawLatencyFlash(renderer, latencyProbe);
+		if (isMeasuring)
+		{
+			EndPhase(&profiler, PHASE_DRAW);
+		}
 
-		drawBricks(renderer, bricks, bricksCollisionMap, BRICK_COLORS, LAYERS, BRICKS_PER_LAYER);
-
-		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-		SDL_RenderFillRect(renderer, &paddle);
-		SDL_RenderFillRect(renderer, &ball);
-
-		SDL_RenderPresent(renderer);
+		PresentPacedFrame(&pacer, renderer);
+		RecordPresent(&latencyProbe, SDL_GetTicks() * (Uint64)1000);
+		if (isFirstFrame)
+		{
+			std::cout << "time to first frame: " << (SDL_GetPerformanceCounter() - launchedAt) * 1000.0 / SDL_GetPerformanceFrequency()
+				<< " ms" << (areAssetsLoaded ? "" : " (placeholder)") << std::endl;
+			isFirstFrame = false;
+		}
 		// Clear front buffer so that the back buffer can be drawn on a fresh front buffer
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 		SDL_RenderClear(renderer);
-
-		// Sleep if processing this current iteration of update loop too fast
-		Uint32 end = SDL_GetTicks();
-		Uint32 tickProcessTime = end - start;
-
-		// if hardware processed this loop iteration faster than target FPS, sleep the remaining time in milliseconds
-		if (tickProcessTime < TARGET_MILLIS_PER_FRAME)
+		if (isMeasuring)
 		{
-			Uint32 sleepTime = TARGET_MILLIS_PER_FRAME - tickProcessTime;
-			timeDelta = ((tickProcessTime + sleepTime) / (float)1000);
-			SDL_Delay(sleepTime);
+			EndPhase(&profiler, PHASE_PRESENT);
 		}
-		else
+
+		// sleeps the rest of the frame when paced, vsync already waited in the present
+		timeDelta = EndPacedFrame(&pacer);
+		if (isMeasuring)
 		{
-			timeDelta = tickProcessTime / (float)1000;
+			EndFrame(&profiler);
+			isGameRunning = isGameRunning && profiler.samples.size() < benchmarkFrames;
 		}
 	}
+	ReportFramePacer(&pacer);
+
+	if (isMeasuring && !profiler.samples.empty())
+	{
+		SDL_RendererInfo rendererInfo;
+		SDL_GetRendererInfo(renderer, &rendererInfo);
+		FrameReport report = BuildFrameReport(profiler);
+		std::cout << "renderer: " << rendererInfo.name << std::endl;
+		PrintFrameReport(report);
+		std::cout << "draw calls:           " << gRenderStats.drawCalls << " (" << gRenderStats.drawCalls / (double)report.frames << " / frame)" << std::endl;
+		std::cout << "texture creations:    " << gRenderStats.textureCreations << std::endl;
+		std::cout << "final score: " << game.score << ", lives: " << game.lives << std::endl;
+	}
 
 	// Possible improvement: Use templates to create an ellipsis function that 
 	// will recursively destroy all resources instantiated in the heap
-	SDL_DestroyTexture(gameOverTexture);
-	SDL_DestroyTexture(gamePauseTexture);
-	SDL_DestroyTexture(livesLabelTexture);
-	SDL_DestroyTexture(pauseLabelTexture);
-	SDL_DestroyTexture(playAgainTexture);
-	SDL_DestroyTexture(scoreLabelTexture);
+	if (areAssetsLoaded)
+	{
+		DestroyGameLabels(&labels);
+	}
+	DestroyAssetLoader(&assets);
+	EndRecording(&recorder);
+	DestroyRenderScaler(&scaler);
 
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
@@ -517,8 +465,6 @@ int main(int argc, char** argv) {
 	renderer = NULL;
 	window = NULL;
 
-	TTF_CloseFont(font);
-	TTF_CloseFont(bigFont);
 	TTF_Quit();
 	SDL_Quit();
 